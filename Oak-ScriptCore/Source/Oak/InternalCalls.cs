@@ -5,52 +5,83 @@ namespace Oak
 {
     public static class InternalCalls
     {
+        #region Log
+        [MethodImplAttribute(MethodImplOptions.InternalCall)]
+        internal extern static void Log_Exception(Exception exception);
+        #endregion
+
         #region Entity
         [MethodImplAttribute(MethodImplOptions.InternalCall)]
-        internal extern static bool Entity_HasComponent(ulong entityID, Type componentType);
+        internal extern static uint Entity_GetHandle(ulong entityID);
         [MethodImplAttribute(MethodImplOptions.InternalCall)]
-        internal extern static ulong Entity_FindEntityByName(string name);
+        internal extern static bool Entity_HasComponent(uint entityHandle, Type componentType);
         [MethodImplAttribute(MethodImplOptions.InternalCall)]
-        internal extern static object GetScriptInstance(ulong entityID);
+        internal extern static ulong Entity_FindEntityByName(string name, out uint entityHandle);
+        [MethodImplAttribute(MethodImplOptions.InternalCall)]
+        internal extern static object GetScriptInstance(uint entityHandle);
         #endregion
 
         #region TransformComponent
         [MethodImplAttribute(MethodImplOptions.InternalCall)]
-        internal extern static void TransformComponent_GetTranslation(ulong entityID, out Vector3 translation);
+        internal extern static void TransformComponent_GetTranslation(uint entityHandle, out Vector3 translation);
+        [MethodImplAttribute(MethodImplOptions.InternalCall)]
+        internal extern static void TransformComponent_SetTranslation(uint entityHandle, ref Vector3 translation);
         [MethodImplAttribute(MethodImplOptions.InternalCall)]
-        internal extern static void TransformComponent_SetTranslation(ulong entityID, ref Vector3 translation);
+        internal extern static void TransformComponent_GetTranslations(uint[] entityHandles, Vector3[] translations);
+        [MethodImplAttribute(MethodImplOptions.InternalCall)]
+        internal extern static void TransformComponent_SetTranslations(uint[] entityHandles, Vector3[] translations);
+        #endregion
+
+        #region Scene
+        [MethodImplAttribute(MethodImplOptions.InternalCall)]
+        internal extern static ulong[] Scene_QueryRegion(ref Vector2 min, ref Vector2 max, out uint[] entityHandles);
+        [MethodImplAttribute(MethodImplOptions.InternalCall)]
+        internal extern static ulong[] Scene_QueryPoint(ref Vector2 point, out uint[] entityHandles);
+        #endregion
+
+        #region Physics2D
+        [MethodImplAttribute(MethodImplOptions.InternalCall)]
+        internal extern static void Physics2D_Raycast(Vector2[] starts, Vector2[] ends, RaycastHit2D[] hits);
+        [MethodImplAttribute(MethodImplOptions.InternalCall)]
+        internal extern static int Physics2D_OverlapBoxes(Vector2[] mins, Vector2[] maxs, ulong[] entityIDs, uint[] counts);
+        [MethodImplAttribute(MethodImplOptions.InternalCall)]
+        internal extern static int Physics2D_QueryPoints(Vector2[] points, ulong[] entityIDs, uint[] counts);
         #endregion
 
         #region Rigidbody2DComponent
         [MethodImplAttribute(MethodImplOptions.InternalCall)]
-        internal extern static void Rigidbody2DComponent_ApplyLinearImpulse(ulong entityID, ref Vector2 impulse, ref Vector2 point, bool wake);
+        internal extern static void Rigidbody2DComponent_ApplyLinearImpulse(uint entityHandle, ref Vector2 impulse, ref Vector2 point, bool wake);
+        [MethodImplAttribute(MethodImplOptions.InternalCall)]
+        internal extern static void Rigidbody2DComponent_GetLinearVelocity(uint entityHandle, out Vector2 linearVelocity);
+        [MethodImplAttribute(MethodImplOptions.InternalCall)]
+        internal extern static void Rigidbody2DComponent_GetLinearVelocities(uint[] entityHandles, Vector2[] linearVelocities);
         [MethodImplAttribute(MethodImplOptions.InternalCall)]
-        internal extern static void Rigidbody2DComponent_GetLinearVelocity(ulong entityID, out Vector2 linearVelocity);
+        internal extern static void Rigidbody2DComponent_SetLinearVelocities(uint[] entityHandles, Vector2[] linearVelocities);
         [MethodImplAttribute(MethodImplOptions.InternalCall)]
-        internal extern static Rigidbody2DComponent.BodyType Rigidbody2DComponent_GetType(ulong entityID);
+        internal extern static Rigidbody2DComponent.BodyType Rigidbody2DComponent_GetType(uint entityHandle);
         [MethodImplAttribute(MethodImplOptions.InternalCall)]
-        internal extern static void Rigidbody2DComponent_SetType(ulong entityID, Rigidbody2DComponent.BodyType type);
+        internal extern static void Rigidbody2DComponent_SetType(uint entityHandle, Rigidbody2DComponent.BodyType type);
         [MethodImplAttribute(MethodImplOptions.InternalCall)]
-        internal extern static void Rigidbody2DComponent_ApplyLinearImpulseToCenter(ulong entityID, ref Vector2 impulse, bool wake);
+        internal extern static void Rigidbody2DComponent_ApplyLinearImpulseToCenter(uint entityHandle, ref Vector2 impulse, bool wake);
         #endregion
 
         #region TextComponent
         [MethodImplAttribute(MethodImplOptions.InternalCall)]
-        internal extern static string TextComponent_GetText(ulong entityID);
+        internal extern static string TextComponent_GetText(uint entityHandle);
         [MethodImplAttribute(MethodImplOptions.InternalCall)]
-        internal extern static void TextComponent_SetText(ulong entityID, string text);
+        internal extern static void TextComponent_SetText(uint entityHandle, string text);
         [MethodImplAttribute(MethodImplOptions.InternalCall)]
-        internal extern static void TextComponent_GetColor(ulong entityID, out Vector4 color);
+        internal extern static void TextComponent_GetColor(uint entityHandle, out Vector4 color);
         [MethodImplAttribute(MethodImplOptions.InternalCall)]
-        internal extern static void TextComponent_SetColor(ulong entityID, ref Vector4 color);
+        internal extern static void TextComponent_SetColor(uint entityHandle, ref Vector4 color);
         [MethodImplAttribute(MethodImplOptions.InternalCall)]
-        internal extern static float TextComponent_GetKerning(ulong entityID);
+        internal extern static float TextComponent_GetKerning(uint entityHandle);
         [MethodImplAttribute(MethodImplOptions.InternalCall)]
-        internal extern static void TextComponent_SetKerning(ulong entityID, float kerning);
+        internal extern static void TextComponent_SetKerning(uint entityHandle, float kerning);
         [MethodImplAttribute(MethodImplOptions.InternalCall)]
-        internal extern static float TextComponent_GetLineSpacing(ulong entityID);
+        internal extern static float TextComponent_GetLineSpacing(uint entityHandle);
         [MethodImplAttribute(MethodImplOptions.InternalCall)]
-        internal extern static void TextComponent_SetLineSpacing(ulong entityID, float lineSpacing);
+        internal extern static void TextComponent_SetLineSpacing(uint entityHandle, float lineSpacing);
         #endregion
 
         #region Rigidbody2DComponent
@@ -17,12 +17,12 @@ namespace Oak
         {
             get
             {
-                InternalCalls.TransformComponent_GetTranslation(Entity.ID, out Vector3 translation);
+                InternalCalls.TransformComponent_GetTranslation(Entity.Handle, out Vector3 translation);
                 return translation;
             }
             set
             {
-                InternalCalls.TransformComponent_SetTranslation(Entity.ID, ref value);
+                InternalCalls.TransformComponent_SetTranslation(Entity.Handle, ref value);
             }
         }
     }
@@ -35,25 +35,25 @@ namespace Oak
         {
             get
             {
-                InternalCalls.Rigidbody2DComponent_GetLinearVelocity(Entity.ID, out Vector2 velocity);
+                InternalCalls.Rigidbody2DComponent_GetLinearVelocity(Entity.Handle, out Vector2 velocity);
                 return velocity;
             }
         }
 
         public BodyType Type
         {
-            get => InternalCalls.Rigidbody2DComponent_GetType(Entity.ID);
-            set => InternalCalls.Rigidbody2DComponent_SetType(Entity.ID, value);
+            get => InternalCalls.Rigidbody2DComponent_GetType(Entity.Handle);
+            set => InternalCalls.Rigidbody2DComponent_SetType(Entity.Handle, value);
         }
 
         public void ApplyLinearImpulse(Vector2 impulse, Vector2 worldPosition, bool wake)
         {
-            InternalCalls.Rigidbody2DComponent_ApplyLinearImpulse(Entity.ID, ref impulse, ref worldPosition, wake);
+            InternalCalls.Rigidbody2DComponent_ApplyLinearImpulse(Entity.Handle, ref impulse, ref worldPosition, wake);
         }
 
         public void ApplyLinearImpulse(Vector2 impulse, bool wake)
         {
-            InternalCalls.Rigidbody2DComponent_ApplyLinearImpulseToCenter(Entity.ID, ref impulse, wake);
+            InternalCalls.Rigidbody2DComponent_ApplyLinearImpulseToCenter(Entity.Handle, ref impulse, wake);
         }
     }
 
@@ -62,34 +62,34 @@ namespace Oak
 
         public string Text
         {
-            get => InternalCalls.TextComponent_GetText(Entity.ID);
-            set => InternalCalls.TextComponent_SetText(Entity.ID, value);
+            get => InternalCalls.TextComponent_GetText(Entity.Handle);
+            set => InternalCalls.TextComponent_SetText(Entity.Handle, value);
         }
 
         public Vector4 Color
         {
             get
             {
-                InternalCalls.TextComponent_GetColor(Entity.ID, out Vector4 color);
+                InternalCalls.TextComponent_GetColor(Entity.Handle, out Vector4 color);
                 return color;
             }
 
             set
             {
-                InternalCalls.TextComponent_SetColor(Entity.ID, ref value);
+                InternalCalls.TextComponent_SetColor(Entity.Handle, ref value);
             }
         }
 
         public float Kerning
         {
-            get => InternalCalls.TextComponent_GetKerning(Entity.ID);
-            set => InternalCalls.TextComponent_SetKerning(Entity.ID, value);
+            get => InternalCalls.TextComponent_GetKerning(Entity.Handle);
+            set => InternalCalls.TextComponent_SetKerning(Entity.Handle, value);
         }
 
         public float LineSpacing
         {
-            get => InternalCalls.TextComponent_GetLineSpacing(Entity.ID);
-            set => InternalCalls.TextComponent_SetLineSpacing(Entity.ID, value);
+            get => InternalCalls.TextComponent_GetLineSpacing(Entity.Handle);
+            set => InternalCalls.TextComponent_SetLineSpacing(Entity.Handle, value);
         }
     }
 }
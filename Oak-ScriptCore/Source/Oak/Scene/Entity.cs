@@ -10,27 +10,37 @@ namespace Oak
         internal Entity(ulong id)
         {
             ID = id;
+            Handle = InternalCalls.Entity_GetHandle(id);
+        }
+
+        // Used when the handle is already known: script instances, name lookups and scene queries
+        internal Entity(ulong id, uint handle)
+        {
+            ID = id;
+            Handle = handle;
         }
 
         public readonly ulong ID;
+        // Native registry handle, internal calls use it instead of looking the ID up
+        internal readonly uint Handle;
 
         public Vector3 Translation
         {
             get
             {
-                InternalCalls.TransformComponent_GetTranslation(ID, out Vector3 result);
+                InternalCalls.TransformComponent_GetTranslation(Handle, out Vector3 result);
                 return result;
             }
             set
             {
-                InternalCalls.TransformComponent_SetTranslation(ID, ref value);
+                InternalCalls.TransformComponent_SetTranslation(Handle, ref value);
             }
         }
 
         public bool HasComponent<T>() where T : Component, new()
         {
             Type componentType = typeof(T);
-            return InternalCalls.Entity_HasComponent(ID, componentType);
+            return InternalCalls.Entity_HasComponent(Handle, componentType);
         }
 
         public T GetComponent<T>() where T : Component, new()
@@ -44,16 +54,38 @@ namespace Oak
         
         public Entity FindEntityByName(string name)
         {
-            ulong entityID = InternalCalls.Entity_FindEntityByName(name);
+            ulong entityID = InternalCalls.Entity_FindEntityByName(name, out uint entityHandle);
             if (entityID == 0)
                 return null;
 
-            return new Entity(entityID);
+            return new Entity(entityID, entityHandle);
+        }
+
+        // Entities whose bounds overlap the region, as of the last frame
+        public Entity[] FindEntitiesInRegion(Vector2 min, Vector2 max)
+        {
+            ulong[] entityIDs = InternalCalls.Scene_QueryRegion(ref min, ref max, out uint[] entityHandles);
+            return ToEntities(entityIDs, entityHandles);
+        }
+
+        public Entity[] FindEntitiesAtPoint(Vector2 point)
+        {
+            ulong[] entityIDs = InternalCalls.Scene_QueryPoint(ref point, out uint[] entityHandles);
+            return ToEntities(entityIDs, entityHandles);
+        }
+
+        private static Entity[] ToEntities(ulong[] entityIDs, uint[] entityHandles)
+        {
+            Entity[] entities = new Entity[entityIDs.Length];
+            for (int i = 0; i < entityIDs.Length; i++)
+                entities[i] = new Entity(entityIDs[i], entityHandles[i]);
+
+            return entities;
         }
 
         public T As<T>() where T : Entity, new()
         {
-            object instance = InternalCalls.GetScriptInstance(ID);
+            object instance = InternalCalls.GetScriptInstance(Handle);
             return instance as T;
         }
     }
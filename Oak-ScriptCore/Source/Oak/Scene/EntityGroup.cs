@@ -0,0 +1,51 @@
+using System;
+
+namespace Oak
+{
+    // A fixed set of entities whose components are read and written with a single
+    // internal call per operation. Arrays passed in must hold at least Count elements
+    public class EntityGroup
+    {
+        private readonly uint[] m_Handles;
+
+        public EntityGroup(Entity[] entities)
+        {
+            m_Handles = new uint[entities.Length];
+            for (int i = 0; i < entities.Length; i++)
+                m_Handles[i] = entities[i].Handle;
+        }
+
+        public int Count => m_Handles.Length;
+
+        public void GetTranslations(Vector3[] translations)
+        {
+            CheckLength(translations.Length);
+            InternalCalls.TransformComponent_GetTranslations(m_Handles, translations);
+        }
+
+        public void SetTranslations(Vector3[] translations)
+        {
+            CheckLength(translations.Length);
+            InternalCalls.TransformComponent_SetTranslations(m_Handles, translations);
+        }
+
+        // Every entity in the group needs a Rigidbody2DComponent
+        public void GetLinearVelocities(Vector2[] linearVelocities)
+        {
+            CheckLength(linearVelocities.Length);
+            InternalCalls.Rigidbody2DComponent_GetLinearVelocities(m_Handles, linearVelocities);
+        }
+
+        public void SetLinearVelocities(Vector2[] linearVelocities)
+        {
+            CheckLength(linearVelocities.Length);
+            InternalCalls.Rigidbody2DComponent_SetLinearVelocities(m_Handles, linearVelocities);
+        }
+
+        private void CheckLength(int length)
+        {
+            if (length < m_Handles.Length)
+                throw new ArgumentException("Array is smaller than the entity group");
+        }
+    }
+}
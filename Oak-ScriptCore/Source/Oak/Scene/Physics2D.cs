@@ -0,0 +1,52 @@
+using System;
+using System.Runtime.InteropServices;
+
+namespace Oak
+{
+    [StructLayout(LayoutKind.Sequential)]
+    public struct RaycastHit2D
+    {
+        public ulong EntityID; // 0 when the ray hit nothing
+        public Vector2 Point;
+        public Vector2 Normal;
+        public float Fraction; // Along the ray, 0 at its start and 1 at its end
+
+        public bool Hit => EntityID != 0;
+        public Entity Entity => Hit ? new Entity(EntityID) : null;
+    }
+
+    // Queries against the colliders of the last physics step. Each call answers a whole batch,
+    // results are written into the arrays passed in so nothing is allocated per query
+    public static class Physics2D
+    {
+        // Closest hit of each segment from starts[i] to ends[i]
+        public static void Raycast(Vector2[] starts, Vector2[] ends, RaycastHit2D[] hits)
+        {
+            CheckLength(ends.Length, starts.Length);
+            CheckLength(hits.Length, starts.Length);
+            InternalCalls.Physics2D_Raycast(starts, ends, hits);
+        }
+
+        // The entities overlapping box i follow those of box i - 1 in entityIDs, counts[i] tells how many there are.
+        // Returns the number of entities found, when it is larger than entityIDs the rest were left out
+        public static int OverlapBoxes(Vector2[] mins, Vector2[] maxs, ulong[] entityIDs, uint[] counts)
+        {
+            CheckLength(maxs.Length, mins.Length);
+            CheckLength(counts.Length, mins.Length);
+            return InternalCalls.Physics2D_OverlapBoxes(mins, maxs, entityIDs, counts);
+        }
+
+        // Entities with a collider containing each point, laid out like OverlapBoxes
+        public static int QueryPoints(Vector2[] points, ulong[] entityIDs, uint[] counts)
+        {
+            CheckLength(counts.Length, points.Length);
+            return InternalCalls.Physics2D_QueryPoints(points, entityIDs, counts);
+        }
+
+        private static void CheckLength(int length, int queryCount)
+        {
+            if (length < queryCount)
+                throw new ArgumentException("Array is smaller than the number of queries");
+        }
+    }
+}
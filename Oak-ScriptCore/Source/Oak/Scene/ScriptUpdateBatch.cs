@@ -0,0 +1,51 @@
+using System;
+using System.Reflection;
+
+namespace Oak
+{
+    // Calls OnUpdate on every instance of one script class, so the engine
+    // crosses into managed code once per class per frame instead of once per entity
+    internal abstract class ScriptUpdateBatch
+    {
+        // Updates entities[first] to entities[first + count - 1]
+        internal abstract void Update(Entity[] entities, int first, int count, float ts);
+
+        // Called by the engine for each script class, returns null when the class has no OnUpdate(float)
+        internal static ScriptUpdateBatch Create(Type type)
+        {
+            MethodInfo method = type.GetMethod("OnUpdate", BindingFlags.Instance | BindingFlags.Public | BindingFlags.NonPublic, null, new Type[] { typeof(float) }, null);
+            if (method == null || method.ReturnType != typeof(void))
+                return null;
+
+            Type batchType = typeof(ScriptUpdateBatch<>).MakeGenericType(type);
+            return (ScriptUpdateBatch)Activator.CreateInstance(batchType, method);
+        }
+    }
+
+    internal sealed class ScriptUpdateBatch<T> : ScriptUpdateBatch where T : Entity
+    {
+        // Open instance delegate, so no reflection is involved per call
+        private readonly Action<T, float> m_OnUpdate;
+
+        public ScriptUpdateBatch(MethodInfo method)
+        {
+            m_OnUpdate = (Action<T, float>)Delegate.CreateDelegate(typeof(Action<T, float>), method);
+        }
+
+        internal override void Update(Entity[] entities, int first, int count, float ts)
+        {
+            for (int i = first; i < first + count; i++)
+            {
+                // One failing script must not stop the rest of the batch
+                try
+                {
+                    m_OnUpdate((T)entities[i], ts);
+                }
+                catch (Exception e)
+                {
+                    InternalCalls.Log_Exception(e);
+                }
+            }
+        }
+    }
+}
@@ -0,0 +1,12 @@
+using System;
+
+namespace Oak
+{
+    // Lets the engine run OnUpdate of this script on worker threads, in parallel with other instances.
+    // OnUpdate must not touch managed state shared between instances. Component writes are deferred
+    // and applied once every update finished, so reads during the update see the previous frame
+    [AttributeUsage(AttributeTargets.Class, Inherited = false)]
+    public sealed class ThreadSafeUpdateAttribute : Attribute
+    {
+    }
+}
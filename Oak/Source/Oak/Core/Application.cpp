@@ -27,7 +27,7 @@ namespace oak {
         m_Window = Window::create(WindowProps(m_Specification.name));
         m_Window->setEventCallback(OAK_BIND_EVENT_FN(Application::onEvent));
 
-        Renderer::init();
+        Renderer::init(m_Specification.renderer2D);
 
         m_ImGuiLayer = new ImGuiLayer();
         pushOverlay(m_ImGuiLayer);
@@ -11,6 +11,8 @@
 
 #include "Oak/ImGui/ImGuiLayer.hpp"
 
+#include "Oak/Renderer/Renderer2DSpecification.hpp"
+
 int main(int argc, char** argv);
 
 namespace oak {
@@ -31,6 +33,7 @@ namespace oak {
         std::string name = "Oak Application";
         std::string workingDirectory;
         ApplicationCommandLineArgs commandLineArgs;
+        Renderer2DSpecification renderer2D;
     };
 
     class Application
@@ -1,7 +1,105 @@
 #include "oakpch.hpp"
 #include "FileSystem.hpp"
 
+#ifndef OAK_PLATFORM_WINDOWS
+    #include <fcntl.h>
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+    #include <unistd.h>
+#endif
+
 namespace oak {
+#ifdef OAK_PLATFORM_WINDOWS
+    MappedFile::MappedFile(const std::filesystem::path& filepath, bool deleteOnClose)
+    {
+        const DWORD flags = FILE_ATTRIBUTE_NORMAL | (deleteOnClose ? FILE_FLAG_DELETE_ON_CLOSE : 0);
+        HANDLE file = CreateFileW(filepath.c_str(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_DELETE, nullptr, OPEN_EXISTING, flags, nullptr);
+        if (file == INVALID_HANDLE_VALUE) {
+            return;
+        }
+
+        LARGE_INTEGER size;
+        if (GetFileSizeEx(file, &size) && size.QuadPart > 0) {
+            HANDLE mapping = CreateFileMappingW(file, nullptr, PAGE_WRITECOPY, 0, 0, nullptr);
+            if (mapping) {
+                m_Data = static_cast<uint8_t*>(MapViewOfFile(mapping, FILE_MAP_COPY, 0, 0, 0));
+                m_Size = m_Data ? (uint64_t)size.QuadPart : 0;
+
+                // The view keeps the mapping, and through it the file, alive
+                CloseHandle(mapping);
+            }
+        }
+
+        CloseHandle(file);
+    }
+
+    void MappedFile::unmap()
+    {
+        if (m_Data) {
+            UnmapViewOfFile(m_Data);
+        }
+
+        m_Data = nullptr;
+        m_Size = 0;
+    }
+#else
+    MappedFile::MappedFile(const std::filesystem::path& filepath, bool deleteOnClose)
+    {
+        const int file = open(filepath.c_str(), O_RDONLY);
+        if (file < 0) {
+            return;
+        }
+
+        struct stat status;
+        if (fstat(file, &status) == 0 && status.st_size > 0) {
+            void* data = mmap(nullptr, (size_t)status.st_size, PROT_READ | PROT_WRITE, MAP_PRIVATE, file, 0);
+            if (data != MAP_FAILED) {
+                m_Data = static_cast<uint8_t*>(data);
+                m_Size = (uint64_t)status.st_size;
+            }
+        }
+
+        // The mapping holds its own reference, an unlinked file stays readable until it is unmapped
+        close(file);
+        if (deleteOnClose) {
+            std::error_code error;
+            std::filesystem::remove(filepath, error);
+        }
+    }
+
+    void MappedFile::unmap()
+    {
+        if (m_Data) {
+            munmap(m_Data, (size_t)m_Size);
+        }
+
+        m_Data = nullptr;
+        m_Size = 0;
+    }
+#endif
+
+    MappedFile::~MappedFile()
+    {
+        unmap();
+    }
+
+    MappedFile::MappedFile(MappedFile&& other) noexcept : m_Data{ other.m_Data }, m_Size{ other.m_Size }
+    {
+        other.m_Data = nullptr;
+        other.m_Size = 0;
+    }
+
+    MappedFile& MappedFile::operator=(MappedFile&& other) noexcept
+    {
+        if (this != &other) {
+            unmap();
+            std::swap(m_Data, other.m_Data);
+            std::swap(m_Size, other.m_Size);
+        }
+
+        return *this;
+    }
+
     Buffer FileSystem::readFileBinary(const std::filesystem::path& filepath)
     {
         std::ifstream stream(filepath, std::ios::binary | std::ios::ate);
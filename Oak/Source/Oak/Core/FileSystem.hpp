@@ -2,7 +2,43 @@
 
 #include "Oak/Core/Buffer.hpp"
 
+#include <filesystem>
+
 namespace oak {
+    // Whole file mapped copy-on-write: pages are read from disk on first access and a write
+    // only ever changes this process's copy. Unmapped on destruction
+    class MappedFile
+    {
+    public:
+        MappedFile() = default;
+        // `deleteOnClose` removes the file once the mapping is gone, for private copies
+        explicit MappedFile(const std::filesystem::path& filepath, bool deleteOnClose = false);
+        ~MappedFile();
+
+        MappedFile(const MappedFile&) = delete;
+        MappedFile& operator=(const MappedFile&) = delete;
+        MappedFile(MappedFile&& other) noexcept;
+        MappedFile& operator=(MappedFile&& other) noexcept;
+
+        uint8_t* data() const { return m_Data; }
+        uint64_t size() const { return m_Size; }
+
+        template<typename T>
+        T* as() const
+        {
+            return reinterpret_cast<T*>(m_Data);
+        }
+
+        operator bool() const { return m_Data != nullptr; }
+
+    private:
+        void unmap();
+
+    private:
+        uint8_t* m_Data = nullptr;
+        uint64_t m_Size = 0;
+    };
+
     class FileSystem
     {
     public:
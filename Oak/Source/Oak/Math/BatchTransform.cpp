@@ -0,0 +1,189 @@
+#include "oakpch.hpp"
+#include "Oak/Math/BatchTransform.hpp"
+
+#if defined(__AVX__)
+    #include <immintrin.h>
+    #define OAK_BATCH_TRANSFORM_AVX
+#elif defined(__SSE2__) || defined(_M_X64) || defined(_M_AMD64)
+    #include <emmintrin.h>
+    #define OAK_BATCH_TRANSFORM_SSE
+#endif
+
+namespace oak::math {
+    // Thin lane abstraction so the kernel below is written once for AVX, SSE and scalar builds
+#if defined(OAK_BATCH_TRANSFORM_AVX)
+    using Lane = __m256;
+    static constexpr size_t laneWidth = 8;
+
+    static inline Lane load(const float* t_data) { return _mm256_load_ps(t_data); }
+    static inline void store(float* t_data, Lane t_value) { _mm256_store_ps(t_data, t_value); }
+    static inline Lane broadcast(float t_value) { return _mm256_set1_ps(t_value); }
+    static inline Lane add(Lane t_a, Lane t_b) { return _mm256_add_ps(t_a, t_b); }
+    static inline Lane sub(Lane t_a, Lane t_b) { return _mm256_sub_ps(t_a, t_b); }
+    static inline Lane mul(Lane t_a, Lane t_b) { return _mm256_mul_ps(t_a, t_b); }
+#elif defined(OAK_BATCH_TRANSFORM_SSE)
+    using Lane = __m128;
+    static constexpr size_t laneWidth = 4;
+
+    static inline Lane load(const float* t_data) { return _mm_load_ps(t_data); }
+    static inline void store(float* t_data, Lane t_value) { _mm_store_ps(t_data, t_value); }
+    static inline Lane broadcast(float t_value) { return _mm_set1_ps(t_value); }
+    static inline Lane add(Lane t_a, Lane t_b) { return _mm_add_ps(t_a, t_b); }
+    static inline Lane sub(Lane t_a, Lane t_b) { return _mm_sub_ps(t_a, t_b); }
+    static inline Lane mul(Lane t_a, Lane t_b) { return _mm_mul_ps(t_a, t_b); }
+#else
+    using Lane = float;
+    static constexpr size_t laneWidth = 1;
+
+    static inline Lane load(const float* t_data) { return *t_data; }
+    static inline void store(float* t_data, Lane t_value) { *t_data = t_value; }
+    static inline Lane broadcast(float t_value) { return t_value; }
+    static inline Lane add(Lane t_a, Lane t_b) { return t_a + t_b; }
+    static inline Lane sub(Lane t_a, Lane t_b) { return t_a - t_b; }
+    static inline Lane mul(Lane t_a, Lane t_b) { return t_a * t_b; }
+#endif
+
+    static_assert(QuadBatch::capacity % laneWidth == 0);
+
+    static size_t paddedCount(size_t t_count)
+    {
+        return (t_count + laneWidth - 1) / laneWidth * laneWidth;
+    }
+
+    void computeQuadBases(std::span<const TransformComponent> transforms, QuadBatch& batch)
+    {
+        OAK_CORE_ASSERT(transforms.size() <= QuadBatch::capacity, "Too many transforms for one quad batch!");
+
+        // Copy clean and world matrices straight out, stage dirty transforms as SoA.
+        // There is no portable SIMD sin/cos, so the half angles are evaluated here
+        const auto count = transforms.size();
+        size_t dirtyCount = 0;
+        for (size_t i = 0; i < count; i++) {
+            const auto& transform = transforms[i];
+
+            // Parented transforms were already resolved by the scene hierarchy pass
+            if (!transform.isDirty() || transform.hasParent()) {
+                const auto& matrix = transform.getWorldTransform();
+                for (glm::length_t axis = 0; axis < 3; axis++) {
+                    batch.axisX[axis][i] = matrix[0][axis];
+                    batch.axisY[axis][i] = matrix[1][axis];
+                    batch.origin[axis][i] = matrix[3][axis];
+                }
+                continue;
+            }
+
+            for (glm::length_t axis = 0; axis < 3; axis++) {
+                batch.halfSin[axis][dirtyCount] = std::sin(transform.getRotation()[axis] * 0.5f);
+                batch.halfCos[axis][dirtyCount] = std::cos(transform.getRotation()[axis] * 0.5f);
+                batch.scale[axis][dirtyCount] = transform.getScale()[axis];
+            }
+            batch.dirtyIndices[dirtyCount] = (uint32_t)i;
+            dirtyCount++;
+        }
+
+        if (dirtyCount == 0) {
+            return;
+        }
+
+        // Pad the last lane with identity rotations
+        const auto padded = paddedCount(dirtyCount);
+        for (size_t i = dirtyCount; i < padded; i++) {
+            for (size_t axis = 0; axis < 3; axis++) {
+                batch.halfSin[axis][i] = 0.0f;
+                batch.halfCos[axis][i] = 1.0f;
+                batch.scale[axis][i] = 1.0f;
+            }
+        }
+
+        const auto one = broadcast(1.0f);
+        const auto two = broadcast(2.0f);
+
+        for (size_t i = 0; i < padded; i += laneWidth) {
+            const auto sx = load(&batch.halfSin[0][i]);
+            const auto sy = load(&batch.halfSin[1][i]);
+            const auto sz = load(&batch.halfSin[2][i]);
+            const auto cx = load(&batch.halfCos[0][i]);
+            const auto cy = load(&batch.halfCos[1][i]);
+            const auto cz = load(&batch.halfCos[2][i]);
+
+            // glm::quat(eulerAngles)
+            const auto qw = add(mul(mul(cx, cy), cz), mul(mul(sx, sy), sz));
+            const auto qx = sub(mul(mul(sx, cy), cz), mul(mul(cx, sy), sz));
+            const auto qy = add(mul(mul(cx, sy), cz), mul(mul(sx, cy), sz));
+            const auto qz = sub(mul(mul(cx, cy), sz), mul(mul(sx, sy), cz));
+
+            // glm::mat3_cast, scaled like TransformComponent::getTransform
+            const auto qxx = mul(qx, qx);
+            const auto qyy = mul(qy, qy);
+            const auto qzz = mul(qz, qz);
+            const auto qxy = mul(qx, qy);
+            const auto qxz = mul(qx, qz);
+            const auto qyz = mul(qy, qz);
+            const auto qwx = mul(qw, qx);
+            const auto qwy = mul(qw, qy);
+            const auto qwz = mul(qw, qz);
+
+            const auto scaleX = load(&batch.scale[0][i]);
+            const auto scaleY = load(&batch.scale[1][i]);
+            const auto scaleZ = load(&batch.scale[2][i]);
+
+            store(&batch.basis[0][0][i], mul(sub(one, mul(two, add(qyy, qzz))), scaleX));
+            store(&batch.basis[0][1][i], mul(mul(two, add(qxy, qwz)), scaleX));
+            store(&batch.basis[0][2][i], mul(mul(two, sub(qxz, qwy)), scaleX));
+
+            store(&batch.basis[1][0][i], mul(mul(two, sub(qxy, qwz)), scaleY));
+            store(&batch.basis[1][1][i], mul(sub(one, mul(two, add(qxx, qzz))), scaleY));
+            store(&batch.basis[1][2][i], mul(mul(two, add(qyz, qwx)), scaleY));
+
+            store(&batch.basis[2][0][i], mul(mul(two, add(qxz, qwy)), scaleZ));
+            store(&batch.basis[2][1][i], mul(mul(two, sub(qyz, qwx)), scaleZ));
+            store(&batch.basis[2][2][i], mul(sub(one, mul(two, add(qxx, qyy))), scaleZ));
+        }
+
+        // Scatter back to the outputs and refresh the cached matrices
+        for (size_t i = 0; i < dirtyCount; i++) {
+            const auto index = batch.dirtyIndices[i];
+            const auto& transform = transforms[index];
+
+            glm::mat4 matrix{ 1.0f };
+            for (glm::length_t column = 0; column < 3; column++) {
+                for (glm::length_t axis = 0; axis < 3; axis++) {
+                    matrix[column][axis] = batch.basis[column][axis][i];
+                }
+            }
+            matrix[3] = glm::vec4(transform.getTranslation(), 1.0f);
+            transform.setCachedTransform(matrix);
+
+            for (glm::length_t axis = 0; axis < 3; axis++) {
+                batch.axisX[axis][index] = matrix[0][axis];
+                batch.axisY[axis][index] = matrix[1][axis];
+                batch.origin[axis][index] = matrix[3][axis];
+            }
+        }
+    }
+
+    void computeQuadCorners(size_t count, QuadBatch& batch)
+    {
+        OAK_CORE_ASSERT(count <= QuadBatch::capacity, "Too many quads for one quad batch!");
+
+        const auto half = broadcast(0.5f);
+
+        const auto padded = paddedCount(count);
+        for (size_t i = 0; i < padded; i += laneWidth) {
+            for (size_t axis = 0; axis < 3; axis++) {
+                const auto origin = load(&batch.origin[axis][i]);
+                const auto halfAxisX = mul(load(&batch.axisX[axis][i]), half);
+                const auto halfAxisY = mul(load(&batch.axisY[axis][i]), half);
+
+                // Local corners are (+-0.5, +-0.5), so each one is origin +- half axis X +- half axis Y
+                const auto left = sub(origin, halfAxisX);
+                const auto right = add(origin, halfAxisX);
+
+                store(&batch.corners[0][axis][i], sub(left, halfAxisY));
+                store(&batch.corners[1][axis][i], sub(right, halfAxisY));
+                store(&batch.corners[2][axis][i], add(right, halfAxisY));
+                store(&batch.corners[3][axis][i], add(left, halfAxisY));
+            }
+        }
+    }
+}
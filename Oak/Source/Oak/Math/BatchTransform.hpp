@@ -0,0 +1,35 @@
+#pragma once
+
+#include "Oak/Scene/Components.hpp"
+
+#include <span>
+
+namespace oak::math {
+    // Structure-of-arrays scratch for transforming many unit quads at once.
+    // Every array is indexed by quad, so the kernel can process several quads per SIMD lane.
+    struct QuadBatch
+    {
+        static constexpr size_t capacity = 256;
+
+        // Transforms with a dirty cached matrix are staged here, packed at the front
+        alignas(32) float halfSin[3][capacity];
+        alignas(32) float halfCos[3][capacity];
+        alignas(32) float scale[3][capacity];
+        alignas(32) float basis[3][3][capacity]; // Scaled rotation columns
+        uint32_t dirtyIndices[capacity];
+
+        // Outputs: scaled X/Y axes and origin of each transform
+        alignas(32) float axisX[3][capacity];
+        alignas(32) float axisY[3][capacity];
+        alignas(32) float origin[3][capacity];
+
+        // Outputs: world position of corner (-,-), (+,-), (+,+), (-,+) of each quad
+        alignas(32) float corners[4][3][capacity];
+    };
+
+    // Fills axisX/axisY/origin for up to QuadBatch::capacity transforms.
+    // Clean transforms are copied from their cached matrix, dirty ones are rebuilt in SIMD and written back to the cache.
+    void computeQuadBases(std::span<const TransformComponent> transforms, QuadBatch& batch);
+    // Fills corners for the first `count` quads from axisX/axisY/origin
+    void computeQuadCorners(size_t count, QuadBatch& batch);
+}
@@ -0,0 +1,40 @@
+#include "oakpch.hpp"
+#include "Oak/Math/Frustum.hpp"
+
+namespace oak::math {
+    Frustum::Frustum(const glm::mat4& viewProjection)
+    {
+        // Gribb/Hartmann plane extraction, glm matrices are column major
+        auto row = [&](int index) {
+            return glm::vec4(viewProjection[0][index], viewProjection[1][index], viewProjection[2][index], viewProjection[3][index]);
+        };
+
+        m_Planes[0] = row(3) + row(0); // Left
+        m_Planes[1] = row(3) - row(0); // Right
+        m_Planes[2] = row(3) + row(1); // Bottom
+        m_Planes[3] = row(3) - row(1); // Top
+        m_Planes[4] = row(3) + row(2); // Near
+        m_Planes[5] = row(3) - row(2); // Far
+    }
+
+    bool Frustum::intersectsAABB(const glm::vec3& center, const glm::vec3& halfExtents) const
+    {
+        // Planes are not normalized, distance and radius are scaled by the same factor so the sign test holds
+        for (const auto& plane : m_Planes) {
+            const glm::vec3 normal = plane;
+            const auto distance = glm::dot(normal, center) + plane.w;
+            const auto radius = glm::dot(halfExtents, glm::abs(normal));
+
+            if (distance + radius < 0.0f) {
+                return false;
+            }
+        }
+
+        return true;
+    }
+
+    bool Frustum::intersectsQuad(const glm::vec3& axisX, const glm::vec3& axisY, const glm::vec3& origin) const
+    {
+        return intersectsAABB(origin, 0.5f * (glm::abs(axisX) + glm::abs(axisY)));
+    }
+}
@@ -0,0 +1,20 @@
+#pragma once
+
+#include <glm/glm.hpp>
+
+namespace oak::math {
+    // View volume of a view-projection matrix, as six inward facing planes (xyz = normal, w = distance)
+    class Frustum
+    {
+    public:
+        Frustum() = default;
+        Frustum(const glm::mat4& viewProjection);
+
+        bool intersectsAABB(const glm::vec3& center, const glm::vec3& halfExtents) const;
+        // Unit quad (corners at +-0.5) placed by its world X/Y axes and origin
+        bool intersectsQuad(const glm::vec3& axisX, const glm::vec3& axisY, const glm::vec3& origin) const;
+
+    private:
+        glm::vec4 m_Planes[6];
+    };
+}
@@ -0,0 +1,65 @@
+#include "oakpch.hpp"
+#include "Oak/Physics/PhysicsThread.hpp"
+
+namespace oak {
+    PhysicsThread::PhysicsThread()
+    {
+        m_Thread = std::thread([this]() { threadLoop(); });
+    }
+
+    PhysicsThread::~PhysicsThread()
+    {
+        {
+            std::unique_lock<std::mutex> lock(m_Mutex);
+            m_TaskDone.wait(lock, [this]() { return !m_Busy; });
+            m_Stopping = true;
+        }
+        m_TaskReady.notify_one();
+
+        m_Thread.join();
+    }
+
+    void PhysicsThread::submit(std::function<void()> task)
+    {
+        {
+            std::unique_lock<std::mutex> lock(m_Mutex);
+            m_TaskDone.wait(lock, [this]() { return !m_Busy; });
+            m_Task = std::move(task);
+            m_Busy = true;
+        }
+        m_TaskReady.notify_one();
+    }
+
+    void PhysicsThread::wait()
+    {
+        OAK_PROFILE_FUNCTION();
+
+        std::unique_lock<std::mutex> lock(m_Mutex);
+        m_TaskDone.wait(lock, [this]() { return !m_Busy; });
+    }
+
+    void PhysicsThread::threadLoop()
+    {
+        while (true) {
+            std::function<void()> task;
+            {
+                std::unique_lock<std::mutex> lock(m_Mutex);
+                m_TaskReady.wait(lock, [this]() { return m_Stopping || m_Task; });
+                if (m_Stopping) {
+                    break;
+                }
+
+                task = std::move(m_Task);
+                m_Task = nullptr;
+            }
+
+            task();
+
+            {
+                std::scoped_lock<std::mutex> lock(m_Mutex);
+                m_Busy = false;
+            }
+            m_TaskDone.notify_all();
+        }
+    }
+}
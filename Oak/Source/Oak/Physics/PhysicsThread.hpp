@@ -0,0 +1,38 @@
+#pragma once
+
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+
+namespace oak {
+    // One long-lived thread that runs physics work while the main thread carries on with the frame.
+    // At most one task is in flight at a time
+    class PhysicsThread
+    {
+    public:
+        PhysicsThread();
+        ~PhysicsThread();
+
+        PhysicsThread(const PhysicsThread&) = delete;
+        PhysicsThread& operator=(const PhysicsThread&) = delete;
+
+        // Waits for the previous task first
+        void submit(std::function<void()> task);
+        // Returns once the submitted task has finished, right away when none is running
+        void wait();
+
+    private:
+        void threadLoop();
+
+    private:
+        std::thread m_Thread;
+        std::mutex m_Mutex;
+        std::condition_variable m_TaskReady;
+        std::condition_variable m_TaskDone;
+
+        std::function<void()> m_Task;
+        bool m_Busy = false; // From submit until the task has finished
+        bool m_Stopping = false;
+    };
+}
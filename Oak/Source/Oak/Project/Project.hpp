@@ -16,6 +16,14 @@ namespace oak {
 
         fs::path assetDirectory;
         fs::path scriptModulePath;
+
+        // Script GC tuning, 0 keeps Mono's defaults
+        uint32_t scriptNurserySize = 0; // Bytes, applied when the script runtime starts
+        uint32_t scriptCollectThreshold = 0; // Bytes allocated before a nursery collection runs between frames
+
+        // Physics is stepped at a fixed rate, rendering interpolates between the last two steps
+        uint32_t physicsTickRate = 60; // Steps per second
+        uint32_t physicsMaxSubSteps = 8; // Steps per frame before the remaining time is dropped
     };
 
     class Project
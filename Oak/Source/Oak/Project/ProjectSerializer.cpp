@@ -23,6 +23,10 @@ namespace oak {
                 out << YAML::Key << "StartScene" << YAML::Value << config.startScene.string();
                 out << YAML::Key << "AssetDirectory" << YAML::Value << config.assetDirectory.string();
                 out << YAML::Key << "ScriptModulePath" << YAML::Value << config.scriptModulePath.string();
+                out << YAML::Key << "ScriptNurserySize" << YAML::Value << config.scriptNurserySize;
+                out << YAML::Key << "ScriptCollectThreshold" << YAML::Value << config.scriptCollectThreshold;
+                out << YAML::Key << "PhysicsTickRate" << YAML::Value << config.physicsTickRate;
+                out << YAML::Key << "PhysicsMaxSubSteps" << YAML::Value << config.physicsMaxSubSteps;
                 out << YAML::EndMap; // Project
             }
             out << YAML::EndMap; // Root
@@ -56,6 +60,10 @@ namespace oak {
         config.startScene = projectNode["StartScene"].as<std::string>();
         config.assetDirectory = projectNode["AssetDirectory"].as<std::string>();
         config.scriptModulePath = projectNode["ScriptModulePath"].as<std::string>();
+        config.scriptNurserySize = projectNode["ScriptNurserySize"].as<uint32_t>(0);
+        config.scriptCollectThreshold = projectNode["ScriptCollectThreshold"].as<uint32_t>(0);
+        config.physicsTickRate = projectNode["PhysicsTickRate"].as<uint32_t>(60);
+        config.physicsMaxSubSteps = projectNode["PhysicsMaxSubSteps"].as<uint32_t>(8);
         return true;
     }
 }
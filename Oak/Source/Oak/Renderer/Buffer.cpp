@@ -32,6 +32,19 @@ namespace oak {
         return nullptr;
     }
 
+    Ref<VertexBuffer> VertexBuffer::createStreaming(uint32_t batchSize, uint32_t framesInFlight, uint32_t batchesPerFrame)
+    {
+        switch (Renderer::getAPI()) {
+            case RendererAPI::API::None:
+                OAK_CORE_ASSERT(false, "RendererAPI::None is currently not supported!"); return nullptr;
+            case RendererAPI::API::OpenGL:
+                return createRef<opengl::VertexBuffer>(batchSize, framesInFlight, batchesPerFrame);
+        }
+
+        OAK_CORE_ASSERT(false, "Unknown RendererAPI!");
+        return nullptr;
+    }
+
     Ref<IndexBuffer> IndexBuffer::create(uint32_t* indices, uint32_t size)
     {
         switch (Renderer::getAPI()) {
@@ -130,11 +130,23 @@ namespace oak {
 
         virtual constexpr auto setData(std::span<std::byte> t_indicies) -> void = 0;
 
+        // Streaming buffers are persistently mapped and split into one region per frame in flight.
+        // The batches of a frame are sub-allocated from its region: map() returns room for one batch at the
+        // write cursor (waiting for the GPU only if it still reads the region), commit() moves the cursor past
+        // what the batch's draw call used, and endFrame() fences the region once and moves on to the next one.
+        // A frame with more batches than its region holds moves on early.
+        // Non-streaming buffers return an empty span and ignore commit() and endFrame().
+        virtual constexpr auto map() -> std::span<std::byte> = 0;
+        virtual constexpr auto commit(uint32_t t_size) -> void = 0;
+        virtual constexpr auto endFrame() -> void = 0;
+        virtual constexpr auto getBaseVertex() const -> uint32_t = 0;
+
         virtual constexpr auto getLayout() const -> const BufferLayout& = 0;
         virtual constexpr auto setLayout(const BufferLayout& t_layout) -> void = 0;
 
         static Ref<VertexBuffer> create(uint32_t size);
         static Ref<VertexBuffer> create(float* vertices, uint32_t size);
+        static Ref<VertexBuffer> createStreaming(uint32_t batchSize, uint32_t framesInFlight = 3, uint32_t batchesPerFrame = 2);
     };
 
     // Currently Oak only supports 32-bit index buffers
@@ -26,14 +26,19 @@ namespace oak {
             s_RendererAPI->clear();
         }
 
-        static void drawIndexed(const oak::Ref<oak::VertexArray>& vertexArray, uint32_t indexCount = 0)
+        static void drawIndexed(const oak::Ref<oak::VertexArray>& vertexArray, uint32_t indexCount = 0, uint32_t baseVertex = 0)
         {
-            s_RendererAPI->drawIndexed(vertexArray, indexCount);
+            s_RendererAPI->drawIndexed(vertexArray, indexCount, baseVertex);
         }
 
-        static void drawLines(const oak::Ref<oak::VertexArray>& vertexArray, uint32_t vertexCount)
+        static void drawIndexedInstanced(const oak::Ref<oak::VertexArray>& vertexArray, uint32_t indexCount, uint32_t instanceCount, uint32_t baseInstance = 0)
         {
-            s_RendererAPI->drawLines(vertexArray, vertexCount);
+            s_RendererAPI->drawIndexedInstanced(vertexArray, indexCount, instanceCount, baseInstance);
+        }
+
+        static void drawLines(const oak::Ref<oak::VertexArray>& vertexArray, uint32_t vertexCount, uint32_t firstVertex = 0)
+        {
+            s_RendererAPI->drawLines(vertexArray, vertexCount, firstVertex);
         }
 
         static void setLineWidth(float width)
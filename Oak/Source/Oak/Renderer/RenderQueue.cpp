@@ -0,0 +1,67 @@
+#include "oakpch.hpp"
+#include "Oak/Renderer/RenderQueue.hpp"
+
+namespace oak {
+    uint64_t makeRenderKey(uint8_t layer, float depth, uint8_t primitive, uint16_t texture)
+    {
+        constexpr uint32_t maxDepth = (1u << 24) - 1;
+
+        // Far quads get the smaller key so they are drawn first
+        const auto clamped = std::clamp(depth, 0.0f, 1.0f);
+        const auto depthBits = (uint64_t)((1.0f - clamped) * (float)maxDepth);
+
+        return ((uint64_t)layer << 56) | (depthBits << 32) | ((uint64_t)primitive << 24) | ((uint64_t)texture << 8);
+    }
+
+    void RenderQueue::sort()
+    {
+        OAK_PROFILE_FUNCTION();
+
+        const auto count = m_Entries.size();
+        if (count < 2) {
+            return;
+        }
+
+        constexpr size_t radix = 256;
+        constexpr size_t passes = sizeof(uint64_t);
+
+        // One histogram per key byte, built in a single read of the keys
+        std::array<std::array<uint32_t, radix>, passes> histograms{};
+        for (const auto& entry : m_Entries) {
+            for (size_t pass = 0; pass < passes; pass++) {
+                histograms[pass][(entry.key >> (pass * 8)) & 0xff]++;
+            }
+        }
+
+        m_Scratch.resize(count);
+        auto* source = m_Entries.data();
+        auto* destination = m_Scratch.data();
+
+        for (size_t pass = 0; pass < passes; pass++) {
+            auto& histogram = histograms[pass];
+            const auto shift = pass * 8;
+
+            // Every key has the same byte here, this pass would not move anything
+            if (histogram[(source[0].key >> shift) & 0xff] == count) {
+                continue;
+            }
+
+            uint32_t offset = 0;
+            for (auto& bucket : histogram) {
+                const auto bucketCount = bucket;
+                bucket = offset;
+                offset += bucketCount;
+            }
+
+            for (size_t i = 0; i < count; i++) {
+                destination[histogram[(source[i].key >> shift) & 0xff]++] = source[i];
+            }
+
+            std::swap(source, destination);
+        }
+
+        if (source != m_Entries.data()) {
+            m_Entries.swap(m_Scratch);
+        }
+    }
+}
@@ -0,0 +1,39 @@
+#pragma once
+
+#include "Oak/Core/Base.hpp"
+
+#include <span>
+#include <vector>
+
+namespace oak {
+    // Sort key layout, most significant first:
+    //   layer (8) | depth (24, back to front) | primitive (8) | texture (16) | unused (8)
+    // Sorting by key draws layers in order, blends far to near, and keeps equal depths grouped by shader and texture
+    // Depth is the normalized device depth in [0, 1], larger is further away
+    uint64_t makeRenderKey(uint8_t layer, float depth, uint8_t primitive, uint16_t texture);
+
+    struct RenderQueueEntry
+    {
+        uint64_t key;
+        uint32_t index; // Into the owner's command storage
+    };
+
+    // Sort keys of one frame's draw commands. The commands themselves are stored by the renderer,
+    // the queue only orders their indices
+    class RenderQueue
+    {
+    public:
+        void push(uint64_t key, uint32_t index) { m_Entries.push_back({ key, index }); }
+        void clear() { m_Entries.clear(); }
+
+        // Stable LSD radix sort on the key bytes, bytes shared by every key are skipped
+        void sort();
+
+        std::span<const RenderQueueEntry> getEntries() const { return m_Entries; }
+        size_t getCount() const { return m_Entries.size(); }
+
+    private:
+        std::vector<RenderQueueEntry> m_Entries;
+        std::vector<RenderQueueEntry> m_Scratch;
+    };
+}
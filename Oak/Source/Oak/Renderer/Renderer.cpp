@@ -5,12 +5,12 @@
 namespace oak {
     Scope<Renderer::SceneData> Renderer::s_SceneData = createScope<Renderer::SceneData>();
 
-    void Renderer::init()
+    void Renderer::init(const Renderer2DSpecification& renderer2DSpecification)
     {
         OAK_PROFILE_FUNCTION();
 
         RenderCommand::init();
-        Renderer2D::init();
+        Renderer2D::init(renderer2DSpecification);
     }
 
     void Renderer::shutdown()
@@ -3,13 +3,14 @@
 #include "Oak/Renderer/RenderCommand.hpp"
 
 #include "Oak/Renderer/OrthographicCamera.hpp"
+#include "Oak/Renderer/Renderer2DSpecification.hpp"
 #include "Oak/Renderer/Shader.hpp"
 
 namespace oak {
     class Renderer
     {
     public:
-        static void init();
+        static void init(const Renderer2DSpecification& renderer2DSpecification = Renderer2DSpecification());
         static void shutdown();
 
         static void onWindowResize(uint32_t width, uint32_t height);
@@ -5,6 +5,12 @@
 #include "Oak/Renderer/Shader.hpp"
 #include "Oak/Renderer/UniformBuffer.hpp"
 #include "Oak/Renderer/RenderCommand.hpp"
+#include "Oak/Renderer/RenderQueue.hpp"
+#include "Oak/Renderer/TextureArrayPool.hpp"
+#include "Oak/Renderer/TextureAtlas.hpp"
+
+#include "Oak/Math/BatchTransform.hpp"
+#include "Oak/Math/Frustum.hpp"
 
 #include <glm/gtc/matrix_transform.hpp>
 #include <glm/gtc/type_ptr.hpp>
@@ -22,6 +28,29 @@ namespace oak {
 
         // Editor-only
         int entityID;
+
+        // Texture array path only
+        float texLayer;
+    };
+
+    // Per-instance record of the instanced quad pipeline. Quad corners are (+-0.5, +-0.5, 0, 1),
+    // so only the X/Y axes and the origin of the transform are needed to place them.
+    struct QuadInstance
+    {
+        glm::vec3 axisX;
+        glm::vec3 axisY;
+        glm::vec3 origin;
+        glm::vec4 color;
+        float texIndex;
+        float tilingFactor;
+
+        // Editor-only
+        int entityID;
+
+        // Texture array path only
+        float texLayer;
+
+        glm::vec4 texRect; // UV min (xy) and max (zw), the atlas region for packed textures
     };
 
     struct CircleVertex
@@ -57,18 +86,45 @@ namespace oak {
         int entityID;
     };
 
+    enum class QueuedPrimitive : uint8_t
+    {
+        Quad = 0,
+        Circle
+    };
+
+    // Quad or circle waiting in the render queue, placed like QuadInstance by its axes and origin
+    struct QueuedDraw
+    {
+        glm::vec3 axisX;
+        glm::vec3 axisY;
+        glm::vec3 origin;
+        glm::vec4 color;
+        glm::vec4 texRect;
+        float tilingFactor; // Thickness for circles
+        float fade;
+        int entityID;
+        uint16_t texture; // Index into Renderer2DData::queuedTextures
+        QueuedPrimitive primitive;
+    };
+
     struct Renderer2DData
     {
         static const uint32_t maxQuads = 20000;
         static const uint32_t maxVertices = maxQuads * 4;
         static const uint32_t maxIndices = maxQuads * 6;
         static const uint32_t maxTextureSlots = 32; // TODO: RenderCaps
+        static const uint32_t framesInFlight = 3;
+        static const uint32_t batchesPerFrame = 2; // Batches one frame can place in a streaming buffer before it moves to the next region
 
         Ref<VertexArray> quadVertexArray;
         Ref<VertexBuffer> quadVertexBuffer;
         Ref<Shader> quadShader;
         Ref<Texture2D> whiteTexture;
 
+        Ref<VertexArray> quadInstanceVertexArray;
+        Ref<VertexBuffer> quadInstanceBuffer;
+        Ref<Shader> quadInstanceShader;
+
         Ref<VertexArray> circleVertexArray;
         Ref<VertexBuffer> circleVertexBuffer;
         Ref<Shader> circleShader;
@@ -85,6 +141,10 @@ namespace oak {
         QuadVertex* quadVertexBufferBase = nullptr;
         QuadVertex* quadVertexBufferPtr = nullptr;
 
+        uint32_t quadInstanceCount = 0;
+        QuadInstance* quadInstanceBufferBase = nullptr;
+        QuadInstance* quadInstanceBufferPtr = nullptr;
+
         uint32_t circleIndexCount = 0;
         CircleVertex* circleVertexBufferBase = nullptr;
         CircleVertex* circleVertexBufferPtr = nullptr;
@@ -101,11 +161,30 @@ namespace oak {
 
         std::array<Ref<Texture2D>, maxTextureSlots> textureSlots;
         uint32_t textureSlotIndex = 1; // 0 = white texture
+        // Renderer ID of the texture, or texture array index when textureArrays is enabled, to its slot in this batch
+        std::unordered_map<uint32_t, uint32_t> textureSlotLookup;
+
+        TextureArrayPool textureArrayPool;
+        std::array<uint32_t, maxTextureSlots> textureArraySlots; // Indices into textureArrayPool
+        TextureArrayPool::Location whiteTextureLocation;
+
+        TextureAtlas textureAtlas;
 
         Ref<Texture2D> fontAtlasTexture;
 
         glm::vec4 quadVertexPositions[4];
 
+        // Quads and circles are only recorded during the scene, their vertices are written in key order by endScene.
+        // Lines and text are not queued, they are written straight into the batch and drawn after quads and circles
+        std::vector<QueuedDraw> queuedDraws;
+        RenderQueue renderQueue;
+        std::vector<Ref<Texture2D>> queuedTextures; // 0 = white texture
+        std::unordered_map<uint32_t, uint16_t> queuedTextureKeys; // Renderer ID to queuedTextures index
+        uint8_t sortLayer = 0;
+
+        math::QuadBatch quadBatch;
+
+        Renderer2DSpecification specification;
         Renderer2D::Statistics stats;
 
         struct CameraData
@@ -114,28 +193,171 @@ namespace oak {
         };
         CameraData cameraBuffer;
         Ref<UniformBuffer> cameraUniformBuffer;
+
+        math::Frustum frustum;
     };
 
     static Renderer2DData s_Data;
 
-    void Renderer2D::init()
+    static const glm::vec4 fullTexRect{ 0.0f, 0.0f, 1.0f, 1.0f };
+
+    // Vertices are written straight into the persistently mapped region of the streaming buffer
+    template<typename T>
+    static T* mapVertexBuffer(const Ref<VertexBuffer>& vertexBuffer)
     {
-        OAK_PROFILE_FUNCTION();
+        return reinterpret_cast<T*>(vertexBuffer->map().data());
+    }
+
+    // Hands the part of the mapped range the batch wrote back to the buffer, the next batch is placed after it
+    template<typename T>
+    static void commitVertexBuffer(const Ref<VertexBuffer>& vertexBuffer, const T* base, const T* ptr)
+    {
+        vertexBuffer->commit((uint32_t)((ptr - base) * sizeof(T)));
+    }
 
-        s_Data.quadVertexArray = VertexArray::create();
+    static bool isOutsideFrustum(const glm::vec3& axisX, const glm::vec3& axisY, const glm::vec3& origin)
+    {
+        return s_Data.specification.frustumCulling && !s_Data.frustum.intersectsQuad(axisX, axisY, origin);
+    }
 
-        s_Data.quadVertexBuffer = VertexBuffer::create(s_Data.maxVertices * sizeof(QuadVertex));
-        s_Data.quadVertexBuffer->setLayout({
-            { ShaderDataType::Float3, "a_Position"     },
-            { ShaderDataType::Float4, "a_Color"        },
-            { ShaderDataType::Float2, "a_TexCoord"     },
-            { ShaderDataType::Float,  "a_TexIndex"     },
-            { ShaderDataType::Float,  "a_TilingFactor" },
-            { ShaderDataType::Int,    "a_EntityID"     }
-        });
-        s_Data.quadVertexArray->addVertexBuffer(s_Data.quadVertexBuffer);
+    // Tests a unit quad against the current camera and counts the result
+    static bool isQuadCulled(const glm::vec3& axisX, const glm::vec3& axisY, const glm::vec3& origin)
+    {
+        if (!s_Data.specification.frustumCulling) {
+            return false;
+        }
+
+        if (isOutsideFrustum(axisX, axisY, origin)) {
+            s_Data.stats.culledCount++;
+            return true;
+        }
+
+        s_Data.stats.visibleCount++;
+        return false;
+    }
+
+    static bool isQuadCulled(const glm::mat4& transform)
+    {
+        return isQuadCulled(glm::vec3(transform[0]), glm::vec3(transform[1]), glm::vec3(transform[3]));
+    }
+
+    static void beginQueue()
+    {
+        s_Data.queuedDraws.clear();
+        s_Data.renderQueue.clear();
+        s_Data.queuedTextures.clear();
+        s_Data.queuedTextureKeys.clear();
+
+        s_Data.queuedTextures.push_back(s_Data.whiteTexture);
+        s_Data.queuedTextureKeys[s_Data.whiteTexture->getRendererID()] = 0;
+        s_Data.sortLayer = 0;
+    }
+
+    static uint16_t getTextureKey(const Ref<Texture2D>& texture)
+    {
+        const auto [it, inserted] = s_Data.queuedTextureKeys.try_emplace(texture->getRendererID(), (uint16_t)s_Data.queuedTextures.size());
+        if (inserted) {
+            OAK_CORE_ASSERT(s_Data.queuedTextures.size() <= UINT16_MAX, "Too many textures in one scene!");
+            s_Data.queuedTextures.push_back(texture);
+        }
+
+        return it->second;
+    }
+
+    // Packed textures are swapped for their atlas page, tiled ones are not since they need the whole texture to repeat
+    static uint16_t getSpriteTextureKey(const Ref<Texture2D>& texture, float tilingFactor, glm::vec4& texRect)
+    {
+        if (s_Data.specification.textureAtlas && !s_Data.specification.textureArrays && tilingFactor == 1.0f) {
+            if (const auto* region = s_Data.textureAtlas.acquire(texture)) {
+                texRect = region->texRect;
+                return getTextureKey(region->page);
+            }
+        }
+
+        return getTextureKey(texture);
+    }
+
+    static void queueDraw(QueuedPrimitive primitive, const glm::vec3& axisX, const glm::vec3& axisY, const glm::vec3& origin, const glm::vec4& color, const glm::vec4& texRect, float tilingFactor, float fade, uint16_t texture, int entityID)
+    {
+        const auto clip = s_Data.cameraBuffer.viewProjection * glm::vec4(origin, 1.0f);
+        const auto depth = clip.w != 0.0f ? clip.z / clip.w * 0.5f + 0.5f : 0.0f;
+
+        s_Data.renderQueue.push(makeRenderKey(s_Data.sortLayer, depth, (uint8_t)primitive, texture), (uint32_t)s_Data.queuedDraws.size());
+        s_Data.queuedDraws.push_back({ axisX, axisY, origin, color, texRect, tilingFactor, fade, entityID, texture, primitive });
+    }
+
+    // Corners of quad `index` after math::computeQuadCorners
+    static void getBatchCorners(const math::QuadBatch& batch, size_t index, glm::vec3 (&positions)[4])
+    {
+        for (size_t corner = 0; corner < 4; corner++) {
+            positions[corner] = { batch.corners[corner][0][index], batch.corners[corner][1][index], batch.corners[corner][2][index] };
+        }
+    }
+
+    static void writeQuadInstance(const glm::vec3& axisX, const glm::vec3& axisY, const glm::vec3& origin, const glm::vec4& color, const glm::vec4& texRect, const glm::vec2& textureSlot, float tilingFactor, int entityID)
+    {
+        s_Data.quadInstanceBufferPtr->axisX = axisX;
+        s_Data.quadInstanceBufferPtr->axisY = axisY;
+        s_Data.quadInstanceBufferPtr->origin = origin;
+        s_Data.quadInstanceBufferPtr->color = color;
+        s_Data.quadInstanceBufferPtr->texIndex = textureSlot.x;
+        s_Data.quadInstanceBufferPtr->tilingFactor = tilingFactor;
+        s_Data.quadInstanceBufferPtr->entityID = entityID;
+        s_Data.quadInstanceBufferPtr->texLayer = textureSlot.y;
+        s_Data.quadInstanceBufferPtr->texRect = texRect;
+        s_Data.quadInstanceBufferPtr++;
+        s_Data.quadInstanceCount++;
+
+        // Index count drives batching for both pipelines so statistics stay identical
+        s_Data.quadIndexCount += 6;
+
+        s_Data.stats.quadCount++;
+    }
+
+    static void writeQuadVertices(const glm::vec3 (&positions)[4], const glm::vec4& color, const glm::vec4& texRect, const glm::vec2& textureSlot, float tilingFactor, int entityID)
+    {
+        constexpr size_t quadVertexCount = 4;
+        const glm::vec2 textureCoords[] = { { texRect.x, texRect.y }, { texRect.z, texRect.y }, { texRect.z, texRect.w }, { texRect.x, texRect.w } };
+
+        for (size_t i = 0; i < quadVertexCount; i++) {
+            s_Data.quadVertexBufferPtr->position = positions[i];
+            s_Data.quadVertexBufferPtr->color = color;
+            s_Data.quadVertexBufferPtr->texCoord = textureCoords[i];
+            s_Data.quadVertexBufferPtr->texIndex = textureSlot.x;
+            s_Data.quadVertexBufferPtr->tilingFactor = tilingFactor;
+            s_Data.quadVertexBufferPtr->entityID = entityID;
+            s_Data.quadVertexBufferPtr->texLayer = textureSlot.y;
+            s_Data.quadVertexBufferPtr++;
+        }
+
+        s_Data.quadIndexCount += 6;
+
+        s_Data.stats.quadCount++;
+    }
+
+    static void writeCircleVertices(const glm::vec3 (&positions)[4], const QueuedDraw& draw)
+    {
+        for (size_t i = 0; i < 4; i++)
+        {
+            s_Data.circleVertexBufferPtr->worldPosition = positions[i];
+            s_Data.circleVertexBufferPtr->localPosition = s_Data.quadVertexPositions[i] * 2.0f;
+            s_Data.circleVertexBufferPtr->color = draw.color;
+            s_Data.circleVertexBufferPtr->thickness = draw.tilingFactor;
+            s_Data.circleVertexBufferPtr->fade = draw.fade;
+            s_Data.circleVertexBufferPtr->entityID = draw.entityID;
+            s_Data.circleVertexBufferPtr++;
+        }
 
-        s_Data.quadVertexBufferBase = new QuadVertex[s_Data.maxVertices];
+        s_Data.circleIndexCount += 6;
+
+        s_Data.stats.quadCount++;
+    }
+
+    void Renderer2D::init(const Renderer2DSpecification& specification)
+    {
+        OAK_PROFILE_FUNCTION();
+
+        s_Data.specification = specification;
 
         uint32_t* quadIndices = new uint32_t[s_Data.maxIndices];
 
@@ -154,13 +376,48 @@ namespace oak {
         }
 
         Ref<IndexBuffer> quadIB = IndexBuffer::create(quadIndices, s_Data.maxIndices);
-        s_Data.quadVertexArray->setIndexBuffer(quadIB);
         delete[] quadIndices;
 
+        // Quads
+        if (s_Data.specification.quadPipeline == QuadPipeline::Instanced) {
+            s_Data.quadInstanceVertexArray = VertexArray::create();
+
+            s_Data.quadInstanceBuffer = VertexBuffer::createStreaming(s_Data.maxQuads * sizeof(QuadInstance), Renderer2DData::framesInFlight, Renderer2DData::batchesPerFrame);
+            s_Data.quadInstanceBuffer->setLayout({
+                { ShaderDataType::Float3, "a_AxisX"        },
+                { ShaderDataType::Float3, "a_AxisY"        },
+                { ShaderDataType::Float3, "a_Origin"       },
+                { ShaderDataType::Float4, "a_Color"        },
+                { ShaderDataType::Float,  "a_TexIndex"     },
+                { ShaderDataType::Float,  "a_TilingFactor" },
+                { ShaderDataType::Int,    "a_EntityID"     },
+                { ShaderDataType::Float,  "a_TexLayer"     },
+                { ShaderDataType::Float4, "a_TexRect"      }
+            });
+            s_Data.quadInstanceVertexArray->addInstanceBuffer(s_Data.quadInstanceBuffer);
+            s_Data.quadInstanceVertexArray->setIndexBuffer(quadIB); // Only the first 6 indices are used
+        }
+        else {
+            s_Data.quadVertexArray = VertexArray::create();
+
+            s_Data.quadVertexBuffer = VertexBuffer::createStreaming(s_Data.maxVertices * sizeof(QuadVertex), Renderer2DData::framesInFlight, Renderer2DData::batchesPerFrame);
+            s_Data.quadVertexBuffer->setLayout({
+                { ShaderDataType::Float3, "a_Position"     },
+                { ShaderDataType::Float4, "a_Color"        },
+                { ShaderDataType::Float2, "a_TexCoord"     },
+                { ShaderDataType::Float,  "a_TexIndex"     },
+                { ShaderDataType::Float,  "a_TilingFactor" },
+                { ShaderDataType::Int,    "a_EntityID"     },
+                { ShaderDataType::Float,  "a_TexLayer"     }
+            });
+            s_Data.quadVertexArray->addVertexBuffer(s_Data.quadVertexBuffer);
+            s_Data.quadVertexArray->setIndexBuffer(quadIB);
+        }
+
         // Circles
         s_Data.circleVertexArray = VertexArray::create();
 
-        s_Data.circleVertexBuffer = VertexBuffer::create(s_Data.maxVertices * sizeof(CircleVertex));
+        s_Data.circleVertexBuffer = VertexBuffer::createStreaming(s_Data.maxVertices * sizeof(CircleVertex), Renderer2DData::framesInFlight, Renderer2DData::batchesPerFrame);
         s_Data.circleVertexBuffer->setLayout({
             { ShaderDataType::Float3, "a_WorldPosition" },
             { ShaderDataType::Float3, "a_LocalPosition" },
@@ -171,24 +428,22 @@ namespace oak {
         });
         s_Data.circleVertexArray->addVertexBuffer(s_Data.circleVertexBuffer);
         s_Data.circleVertexArray->setIndexBuffer(quadIB); // Use quad IB
-        s_Data.circleVertexBufferBase = new CircleVertex[s_Data.maxVertices];
 
         // Lines
         s_Data.lineVertexArray = VertexArray::create();
 
-        s_Data.lineVertexBuffer = VertexBuffer::create(s_Data.maxVertices * sizeof(LineVertex));
+        s_Data.lineVertexBuffer = VertexBuffer::createStreaming(s_Data.maxVertices * sizeof(LineVertex), Renderer2DData::framesInFlight, Renderer2DData::batchesPerFrame);
         s_Data.lineVertexBuffer->setLayout({
             { ShaderDataType::Float3, "a_Position" },
             { ShaderDataType::Float4, "a_Color"    },
             { ShaderDataType::Int,    "a_EntityID" }
         });
         s_Data.lineVertexArray->addVertexBuffer(s_Data.lineVertexBuffer);
-        s_Data.lineVertexBufferBase = new LineVertex[s_Data.maxVertices];
 
         // Text
         s_Data.textVertexArray = VertexArray::create();
 
-        s_Data.textVertexBuffer = VertexBuffer::create(s_Data.maxVertices * sizeof(TextVertex));
+        s_Data.textVertexBuffer = VertexBuffer::createStreaming(s_Data.maxVertices * sizeof(TextVertex), Renderer2DData::framesInFlight, Renderer2DData::batchesPerFrame);
         s_Data.textVertexBuffer->setLayout({
             { ShaderDataType::Float3, "a_Position"     },
             { ShaderDataType::Float4, "a_Color"        },
@@ -197,7 +452,6 @@ namespace oak {
         });
         s_Data.textVertexArray->addVertexBuffer(s_Data.textVertexBuffer);
         s_Data.textVertexArray->setIndexBuffer(quadIB);
-        s_Data.textVertexBufferBase = new TextVertex[s_Data.maxVertices];
 
         s_Data.whiteTexture = Texture2D::create(TextureSpecification());
         uint32_t whiteTextureData = 0xffffffff;
@@ -208,13 +462,23 @@ namespace oak {
             samplers[i] = i;
         }
 
-        s_Data.quadShader = Shader::create("assets/shaders/Renderer2D_Quad.glsl");
+        // The array shaders sample sampler2DArray layers instead of individual textures
+        const auto textureArrays = s_Data.specification.textureArrays;
+        if (s_Data.specification.quadPipeline == QuadPipeline::Instanced) {
+            s_Data.quadInstanceShader = Shader::create(textureArrays ? "assets/shaders/Renderer2D_QuadInstancedArray.glsl" : "assets/shaders/Renderer2D_QuadInstanced.glsl");
+        }
+        else {
+            s_Data.quadShader = Shader::create(textureArrays ? "assets/shaders/Renderer2D_QuadArray.glsl" : "assets/shaders/Renderer2D_Quad.glsl");
+        }
         s_Data.circleShader = Shader::create("assets/shaders/Renderer2D_Circle.glsl");
         s_Data.lineShader = Shader::create("assets/shaders/Renderer2D_Line.glsl");
         s_Data.textShader = Shader::create("assets/shaders/Renderer2D_Text.glsl");
 
         // Set first texture slot to 0
         s_Data.textureSlots[0] = s_Data.whiteTexture;
+        if (textureArrays) {
+            s_Data.whiteTextureLocation = s_Data.textureArrayPool.acquire(s_Data.whiteTexture);
+        }
 
         s_Data.quadVertexPositions[0] = { -0.5f, -0.5f, 0.0f, 1.0f };
         s_Data.quadVertexPositions[1] = {  0.5f, -0.5f, 0.0f, 1.0f };
@@ -228,7 +492,15 @@ namespace oak {
     {
         OAK_PROFILE_FUNCTION();
 
-        delete[] s_Data.quadVertexBufferBase;
+        // Vertex storage is owned by the streaming vertex buffers
+        s_Data.quadVertexBufferBase = nullptr;
+        s_Data.quadInstanceBufferBase = nullptr;
+        s_Data.circleVertexBufferBase = nullptr;
+        s_Data.lineVertexBufferBase = nullptr;
+        s_Data.textVertexBufferBase = nullptr;
+
+        s_Data.textureArrayPool.clear();
+        s_Data.textureAtlas.clear();
     }
 
     void Renderer2D::beginScene(const OrthographicCamera& camera)
@@ -237,7 +509,9 @@ namespace oak {
 
         s_Data.cameraBuffer.viewProjection = camera.getViewProjectionMatrix();
         s_Data.cameraUniformBuffer->setData(&s_Data.cameraBuffer, sizeof(Renderer2DData::CameraData));
+        s_Data.frustum = math::Frustum(s_Data.cameraBuffer.viewProjection);
 
+        beginQueue();
         startBatch();
     }
 
@@ -247,7 +521,9 @@ namespace oak {
 
         s_Data.cameraBuffer.viewProjection = camera.getProjection() * glm::inverse(transform);
         s_Data.cameraUniformBuffer->setData(&s_Data.cameraBuffer, sizeof(Renderer2DData::CameraData));
+        s_Data.frustum = math::Frustum(s_Data.cameraBuffer.viewProjection);
 
+        beginQueue();
         startBatch();
     }
 
@@ -257,7 +533,9 @@ namespace oak {
 
         s_Data.cameraBuffer.viewProjection = camera.getViewProjection();
         s_Data.cameraUniformBuffer->setData(&s_Data.cameraBuffer, sizeof(Renderer2DData::CameraData));
+        s_Data.frustum = math::Frustum(s_Data.cameraBuffer.viewProjection);
 
+        beginQueue();
         startBatch();
     }
 
@@ -265,70 +543,167 @@ namespace oak {
     {
         OAK_PROFILE_FUNCTION();
 
+        drawQueue();
         flush();
+
+        // Nothing queued refers to a region anymore, so this is where the atlas may drop and repack pages
+        s_Data.textureAtlas.update();
+
+        // Every batch of the scene shares one region per buffer, fenced once here
+        for (const auto* vertexBuffer : { &s_Data.quadVertexBuffer, &s_Data.quadInstanceBuffer, &s_Data.circleVertexBuffer, &s_Data.lineVertexBuffer, &s_Data.textVertexBuffer }) {
+            if (*vertexBuffer) {
+                (*vertexBuffer)->endFrame();
+            }
+        }
+    }
+
+    void Renderer2D::drawQueue()
+    {
+        OAK_PROFILE_FUNCTION();
+
+        s_Data.renderQueue.sort();
+
+        const auto instanced = s_Data.specification.quadPipeline == QuadPipeline::Instanced;
+        const auto entries = s_Data.renderQueue.getEntries();
+        auto& batch = s_Data.quadBatch;
+
+        for (size_t first = 0; first < entries.size(); first += math::QuadBatch::capacity) {
+            const auto count = std::min(entries.size() - first, math::QuadBatch::capacity);
+
+            // Gather the chunk in sorted order, so its corners are expanded by one pass of the SoA kernel
+            for (size_t i = 0; i < count; i++) {
+                const auto& draw = s_Data.queuedDraws[entries[first + i].index];
+                for (glm::length_t axis = 0; axis < 3; axis++) {
+                    batch.axisX[axis][i] = draw.axisX[axis];
+                    batch.axisY[axis][i] = draw.axisY[axis];
+                    batch.origin[axis][i] = draw.origin[axis];
+                }
+            }
+            math::computeQuadCorners(count, batch);
+
+            for (size_t i = 0; i < count; i++) {
+                const auto& draw = s_Data.queuedDraws[entries[first + i].index];
+
+                glm::vec3 positions[4];
+                if (draw.primitive == QueuedPrimitive::Circle) {
+                    if (s_Data.circleIndexCount >= Renderer2DData::maxIndices) {
+                        nextBatch();
+                    }
+
+                    getBatchCorners(batch, i, positions);
+                    writeCircleVertices(positions, draw);
+                    continue;
+                }
+
+                // flush() draws quads before circles, so a quad sorted after pending circles needs a new batch to blend over them.
+                // Translucent quads and circles have to interleave by depth, so this is the price of correct blending
+                if (s_Data.quadIndexCount >= Renderer2DData::maxIndices || s_Data.circleIndexCount) {
+                    nextBatch();
+                }
+
+                const auto textureSlot = getTextureSlot(s_Data.queuedTextures[draw.texture]);
+
+                if (instanced) {
+                    writeQuadInstance(draw.axisX, draw.axisY, draw.origin, draw.color, draw.texRect, textureSlot, draw.tilingFactor, draw.entityID);
+                }
+                else {
+                    getBatchCorners(batch, i, positions);
+                    writeQuadVertices(positions, draw.color, draw.texRect, textureSlot, draw.tilingFactor, draw.entityID);
+                }
+            }
+        }
+
+        s_Data.queuedDraws.clear();
+        s_Data.renderQueue.clear();
+        s_Data.queuedTextures.clear();
+        s_Data.queuedTextureKeys.clear();
     }
 
     void Renderer2D::startBatch()
     {
         s_Data.quadIndexCount = 0;
-        s_Data.quadVertexBufferPtr = s_Data.quadVertexBufferBase;
+        s_Data.quadInstanceCount = 0;
+        if (s_Data.specification.quadPipeline == QuadPipeline::Instanced) {
+            s_Data.quadInstanceBufferBase = mapVertexBuffer<QuadInstance>(s_Data.quadInstanceBuffer);
+            s_Data.quadInstanceBufferPtr = s_Data.quadInstanceBufferBase;
+        }
+        else {
+            s_Data.quadVertexBufferBase = mapVertexBuffer<QuadVertex>(s_Data.quadVertexBuffer);
+            s_Data.quadVertexBufferPtr = s_Data.quadVertexBufferBase;
+        }
 
         s_Data.circleIndexCount = 0;
+        s_Data.circleVertexBufferBase = mapVertexBuffer<CircleVertex>(s_Data.circleVertexBuffer);
         s_Data.circleVertexBufferPtr = s_Data.circleVertexBufferBase;
 
         s_Data.lineVertexCount = 0;
+        s_Data.lineVertexBufferBase = mapVertexBuffer<LineVertex>(s_Data.lineVertexBuffer);
         s_Data.lineVertexBufferPtr = s_Data.lineVertexBufferBase;
 
         s_Data.textIndexCount = 0;
+        s_Data.textVertexBufferBase = mapVertexBuffer<TextVertex>(s_Data.textVertexBuffer);
         s_Data.textVertexBufferPtr = s_Data.textVertexBufferBase;
 
         s_Data.textureSlotIndex = 1;
+        s_Data.textureSlotLookup.clear();
+        if (s_Data.specification.textureArrays) {
+            s_Data.textureArraySlots[0] = s_Data.whiteTextureLocation.array;
+            s_Data.textureSlotLookup[s_Data.whiteTextureLocation.array] = 0;
+        }
+        else {
+            s_Data.textureSlotLookup[s_Data.whiteTexture->getRendererID()] = 0;
+        }
     }
 
     void Renderer2D::flush()
     {
+        // Vertex data already lives in the mapped buffer regions, so there is nothing to upload.
+        // After each draw the written range is committed, the next batch continues behind it.
         if (s_Data.quadIndexCount) {
-            auto dataSize = (uint32_t)((uint8_t*)s_Data.quadVertexBufferPtr - (uint8_t*)s_Data.quadVertexBufferBase);
-            s_Data.quadVertexBuffer->setData(std::span<std::byte>(reinterpret_cast<std::byte*>(s_Data.quadVertexBufferBase), dataSize));
-
             // Bind textures
             for (uint32_t i = 0; i < s_Data.textureSlotIndex; i++) {
-                s_Data.textureSlots[i]->bind(i);
+                if (s_Data.specification.textureArrays) {
+                    s_Data.textureArrayPool.getArray(s_Data.textureArraySlots[i])->bind(i);
+                }
+                else {
+                    s_Data.textureSlots[i]->bind(i);
+                }
             }
 
-            s_Data.quadShader->bind();
-            RenderCommand::drawIndexed(s_Data.quadVertexArray, s_Data.quadIndexCount);
+            if (s_Data.specification.quadPipeline == QuadPipeline::Instanced) {
+                s_Data.quadInstanceShader->bind();
+                RenderCommand::drawIndexedInstanced(s_Data.quadInstanceVertexArray, 6, s_Data.quadInstanceCount, s_Data.quadInstanceBuffer->getBaseVertex());
+                commitVertexBuffer(s_Data.quadInstanceBuffer, s_Data.quadInstanceBufferBase, s_Data.quadInstanceBufferPtr);
+            }
+            else {
+                s_Data.quadShader->bind();
+                RenderCommand::drawIndexed(s_Data.quadVertexArray, s_Data.quadIndexCount, s_Data.quadVertexBuffer->getBaseVertex());
+                commitVertexBuffer(s_Data.quadVertexBuffer, s_Data.quadVertexBufferBase, s_Data.quadVertexBufferPtr);
+            }
             s_Data.stats.drawCalls++;
         }
 
         if (s_Data.circleIndexCount) {
-            auto dataSize = (uint32_t)((uint8_t*)s_Data.circleVertexBufferPtr - (uint8_t*)s_Data.circleVertexBufferBase);
-            s_Data.circleVertexBuffer->setData(std::span<std::byte>(reinterpret_cast<std::byte*>(s_Data.circleVertexBufferBase), dataSize));
-
             s_Data.circleShader->bind();
-            RenderCommand::drawIndexed(s_Data.circleVertexArray, s_Data.circleIndexCount);
+            RenderCommand::drawIndexed(s_Data.circleVertexArray, s_Data.circleIndexCount, s_Data.circleVertexBuffer->getBaseVertex());
+            commitVertexBuffer(s_Data.circleVertexBuffer, s_Data.circleVertexBufferBase, s_Data.circleVertexBufferPtr);
             s_Data.stats.drawCalls++;
         }
 
         if (s_Data.lineVertexCount) {
-            auto dataSize = (uint32_t)((uint8_t*)s_Data.lineVertexBufferPtr - (uint8_t*)s_Data.lineVertexBufferBase);
-            s_Data.lineVertexBuffer->setData(std::span<std::byte>(reinterpret_cast<std::byte*>(s_Data.lineVertexBufferBase), dataSize));
-
             s_Data.lineShader->bind();
             RenderCommand::setLineWidth(s_Data.lineWidth);
-            RenderCommand::drawLines(s_Data.lineVertexArray, s_Data.lineVertexCount);
+            RenderCommand::drawLines(s_Data.lineVertexArray, s_Data.lineVertexCount, s_Data.lineVertexBuffer->getBaseVertex());
+            commitVertexBuffer(s_Data.lineVertexBuffer, s_Data.lineVertexBufferBase, s_Data.lineVertexBufferPtr);
             s_Data.stats.drawCalls++;
         }
 
         if (s_Data.textIndexCount) {
-            auto dataSize = (uint32_t)((uint8_t*)s_Data.textVertexBufferPtr - (uint8_t*)s_Data.textVertexBufferBase);
-            s_Data.textVertexBuffer->setData(std::span<std::byte>(reinterpret_cast<std::byte*>(s_Data.textVertexBufferBase), dataSize));
-
-            auto buf = s_Data.textVertexBufferBase;
             s_Data.fontAtlasTexture->bind(0);
 
             s_Data.textShader->bind();
-            RenderCommand::drawIndexed(s_Data.textVertexArray, s_Data.textIndexCount);
+            RenderCommand::drawIndexed(s_Data.textVertexArray, s_Data.textIndexCount, s_Data.textVertexBuffer->getBaseVertex());
+            commitVertexBuffer(s_Data.textVertexBuffer, s_Data.textVertexBufferBase, s_Data.textVertexBufferPtr);
             s_Data.stats.drawCalls++;
         }
     }
@@ -371,72 +746,99 @@ namespace oak {
     {
         OAK_PROFILE_FUNCTION();
 
-        constexpr size_t quadVertexCount = 4;
-        const auto textureIndex = 0.0f; // White Texture
-        constexpr glm::vec2 textureCoords[] = { { 0.0f, 0.0f }, { 1.0f, 0.0f }, { 1.0f, 1.0f }, { 0.0f, 1.0f } };
+        const auto textureKey = 0; // White Texture
         const auto tilingFactor = 1.0f;
 
-        if (s_Data.quadIndexCount >= Renderer2DData::maxIndices) {
-            nextBatch();
+        if (isQuadCulled(transform)) {
+            return;
         }
 
-        for (size_t i = 0; i < quadVertexCount; i++) {
-            s_Data.quadVertexBufferPtr->position = transform * s_Data.quadVertexPositions[i];
-            s_Data.quadVertexBufferPtr->color = color;
-            s_Data.quadVertexBufferPtr->texCoord = textureCoords[i];
-            s_Data.quadVertexBufferPtr->texIndex = textureIndex;
-            s_Data.quadVertexBufferPtr->tilingFactor = tilingFactor;
-            s_Data.quadVertexBufferPtr->entityID = entityID;
-            s_Data.quadVertexBufferPtr++;
+        queueDraw(QueuedPrimitive::Quad, glm::vec3(transform[0]), glm::vec3(transform[1]), glm::vec3(transform[3]), color, fullTexRect, tilingFactor, 0.0f, textureKey, entityID);
+    }
+
+    void Renderer2D::drawQuad(const glm::mat4& transform, const oak::Ref<oak::Texture2D>& texture, float tilingFactor, const glm::vec4& tintColor, int entityID)
+    {
+        OAK_PROFILE_FUNCTION();
+
+        if (isQuadCulled(transform)) {
+            return;
         }
 
-        s_Data.quadIndexCount += 6;
+        auto texRect = fullTexRect;
+        const auto textureKey = getSpriteTextureKey(texture, tilingFactor, texRect);
 
-        s_Data.stats.quadCount++;
+        queueDraw(QueuedPrimitive::Quad, glm::vec3(transform[0]), glm::vec3(transform[1]), glm::vec3(transform[3]), tintColor, texRect, tilingFactor, 0.0f, textureKey, entityID);
     }
 
-    void Renderer2D::drawQuad(const glm::mat4& transform, const oak::Ref<oak::Texture2D>& texture, float tilingFactor, const glm::vec4& tintColor, int entityID)
+    void Renderer2D::drawQuads(std::span<const TransformComponent> transforms, std::span<const SpriteRendererComponent> sprites, std::span<const entt::entity> entities)
     {
         OAK_PROFILE_FUNCTION();
 
-        constexpr size_t quadVertexCount = 4;
-        constexpr glm::vec2 textureCoords[] = { { 0.0f, 0.0f }, { 1.0f, 0.0f }, { 1.0f, 1.0f }, { 0.0f, 1.0f } };
+        OAK_CORE_ASSERT(transforms.size() == sprites.size() && sprites.size() == entities.size(), "Sprite batch spans must have the same size!");
 
-        if (s_Data.quadIndexCount >= Renderer2DData::maxIndices) {
-            nextBatch();
-        }
+        auto& batch = s_Data.quadBatch;
+
+        for (size_t first = 0; first < transforms.size(); first += math::QuadBatch::capacity) {
+            const auto count = std::min(transforms.size() - first, math::QuadBatch::capacity);
+
+            // Transform the whole chunk up front, the loop below only copies the results out
+            math::computeQuadBases(transforms.subspan(first, count), batch);
 
-        float textureIndex = 0.0f;
-        for (uint32_t i = 1; i < s_Data.textureSlotIndex; i++) {
-            if (*s_Data.textureSlots[i] == *texture) {
-                textureIndex = (float)i;
-                break;
+            for (size_t i = 0; i < count; i++) {
+                const glm::vec3 axisX = { batch.axisX[0][i], batch.axisX[1][i], batch.axisX[2][i] };
+                const glm::vec3 axisY = { batch.axisY[0][i], batch.axisY[1][i], batch.axisY[2][i] };
+                const glm::vec3 origin = { batch.origin[0][i], batch.origin[1][i], batch.origin[2][i] };
+
+                // Culled before the texture lookup, so off-screen sprites never take a key
+                if (isQuadCulled(axisX, axisY, origin)) {
+                    continue;
+                }
+
+                const auto& sprite = sprites[first + i];
+                const auto entityID = (int)entities[first + i];
+
+                uint16_t textureKey = 0; // White Texture
+                auto tilingFactor = 1.0f;
+                auto texRect = fullTexRect;
+                if (sprite.texture) {
+                    textureKey = getSpriteTextureKey(sprite.texture, sprite.tilingFactor, texRect);
+                    tilingFactor = sprite.tilingFactor;
+                }
+
+                queueDraw(QueuedPrimitive::Quad, axisX, axisY, origin, sprite.color, texRect, tilingFactor, 0.0f, textureKey, entityID);
             }
         }
+    }
 
-        if (textureIndex == 0.0f) {
-            if (s_Data.textureSlotIndex >= Renderer2DData::maxTextureSlots) {
-                nextBatch();
-            }
+    glm::vec2 Renderer2D::getTextureSlot(const Ref<Texture2D>& texture)
+    {
+        // With texture arrays the slot is shared by every layer of the array
+        auto key = texture->getRendererID();
+        auto layer = 0.0f;
+        if (s_Data.specification.textureArrays) {
+            const auto location = s_Data.textureArrayPool.acquire(texture);
+            key = location.array;
+            layer = (float)location.layer;
+        }
 
-            textureIndex = (float)s_Data.textureSlotIndex;
-            s_Data.textureSlots[s_Data.textureSlotIndex] = texture;
-            s_Data.textureSlotIndex++;
+        if (const auto it = s_Data.textureSlotLookup.find(key); it != s_Data.textureSlotLookup.end()) {
+            return { (float)it->second, layer };
         }
 
-        for (size_t i = 0; i < quadVertexCount; i++) {
-            s_Data.quadVertexBufferPtr->position = transform * s_Data.quadVertexPositions[i];
-            s_Data.quadVertexBufferPtr->color = tintColor;
-            s_Data.quadVertexBufferPtr->texCoord = textureCoords[i];
-            s_Data.quadVertexBufferPtr->texIndex = textureIndex;
-            s_Data.quadVertexBufferPtr->tilingFactor = tilingFactor;
-            s_Data.quadVertexBufferPtr->entityID = entityID;
-            s_Data.quadVertexBufferPtr++;
+        if (s_Data.textureSlotIndex >= Renderer2DData::maxTextureSlots) {
+            nextBatch();
         }
 
-        s_Data.quadIndexCount += 6;
+        const auto slot = s_Data.textureSlotIndex++;
+        if (s_Data.specification.textureArrays) {
+            s_Data.textureArraySlots[slot] = key;
+        }
+        else {
+            s_Data.textureSlots[slot] = texture;
+        }
+        s_Data.textureSlotLookup[key] = slot;
 
-        s_Data.stats.quadCount++;
+        return { (float)slot, layer };
     }
 
     void Renderer2D::drawRotatedQuad(const glm::vec2& position, const glm::vec2& size, float rotation, const glm::vec4& color)
@@ -471,24 +873,11 @@ namespace oak {
     {
         OAK_PROFILE_FUNCTION();
 
-        // TODO: implement for circles
-        // if (s_Data.QuadIndexCount >= Renderer2DData::maxIndices)
-        // 	NextBatch();
-
-        for (size_t i = 0; i < 4; i++)
-        {
-            s_Data.circleVertexBufferPtr->worldPosition = transform * s_Data.quadVertexPositions[i];
-            s_Data.circleVertexBufferPtr->localPosition = s_Data.quadVertexPositions[i] * 2.0f;
-            s_Data.circleVertexBufferPtr->color = color;
-            s_Data.circleVertexBufferPtr->thickness = thickness;
-            s_Data.circleVertexBufferPtr->fade = fade;
-            s_Data.circleVertexBufferPtr->entityID = entityID;
-            s_Data.circleVertexBufferPtr++;
+        if (isQuadCulled(transform)) {
+            return;
         }
 
-        s_Data.circleIndexCount += 6;
-
-        s_Data.stats.quadCount++;
+        queueDraw(QueuedPrimitive::Circle, glm::vec3(transform[0]), glm::vec3(transform[1]), glm::vec3(transform[3]), color, fullTexRect, thickness, fade, 0, entityID);
     }
 
     void Renderer2D::drawLine(const glm::vec3& p0, glm::vec3& p1, const glm::vec4& color, int entityID)
@@ -542,13 +931,11 @@ namespace oak {
         }
     }
 
-    void Renderer2D::drawString(const std::string& string, oak::Ref<oak::Font> font, const glm::mat4& transform, const TextParams& textParams, int entityID)
+    // Calls `callback(glyph, quadMin, quadMax)` with the local-space quad of every glyph of the string
+    template<typename Func>
+    static void layoutString(const std::string& string, const msdf_atlas::FontGeometry& fontGeometry, const Renderer2D::TextParams& textParams, Func&& callback)
     {
-        const auto& fontGeometry = font->getMSDFData()->fontGeometry;
         const auto& metrics = fontGeometry.getMetrics();
-        auto fontAtlas = font->getAtlasTexture();
-
-        s_Data.fontAtlasTexture = fontAtlas;
 
         auto x = 0.0;
         auto fsScale = 1.0 / (metrics.ascenderY - metrics.descenderY);
@@ -595,11 +982,6 @@ namespace oak {
                 return;
             }
 
-            double al, ab, ar, at;
-            glyph->getQuadAtlasBounds(al, ab, ar, at);
-            glm::vec2 texCoordMin((float)al, (float)ab);
-            glm::vec2 texCoordMax((float)ar, (float)at);
-
             double pl, pb, pr, pt;
             glyph->getQuadPlaneBounds(pl, pb, pr, pt);
             glm::vec2 quadMin((float)pl, (float)pb);
@@ -609,8 +991,41 @@ namespace oak {
             quadMin += glm::vec2(x, y);
             quadMax += glm::vec2(x, y);
 
-            auto texelWidth = 1.0f / fontAtlas->getWidth();
-            auto texelHeight = 1.0f / fontAtlas->getHeight();
+            callback(*glyph, quadMin, quadMax);
+
+            if (i < string.size() - 1) {
+                auto advance = glyph->getAdvance();
+                auto nextCharacter = string[i + 1];
+                fontGeometry.getAdvance(advance, character, nextCharacter);
+
+                x += fsScale * advance + textParams.kerning;
+            }
+        }
+    }
+
+    void Renderer2D::drawString(const std::string& string, oak::Ref<oak::Font> font, const glm::mat4& transform, const TextParams& textParams, int entityID)
+    {
+        auto fontAtlas = font->getAtlasTexture();
+
+        s_Data.fontAtlasTexture = fontAtlas;
+
+        const auto texelWidth = 1.0f / fontAtlas->getWidth();
+        const auto texelHeight = 1.0f / fontAtlas->getHeight();
+
+        layoutString(string, font->getMSDFData()->fontGeometry, textParams, [&](const msdf_atlas::GlyphGeometry& glyph, const glm::vec2& quadMin, const glm::vec2& quadMax) {
+            // Glyph quad in world space
+            const auto quadSize = quadMax - quadMin;
+            const auto quadCenter = 0.5f * (quadMin + quadMax);
+            if (isOutsideFrustum(glm::vec3(transform[0]) * quadSize.x, glm::vec3(transform[1]) * quadSize.y, glm::vec3(transform * glm::vec4(quadCenter, 0.0f, 1.0f)))) {
+                s_Data.stats.culledGlyphCount++;
+                return;
+            }
+
+            double al, ab, ar, at;
+            glyph.getQuadAtlasBounds(al, ab, ar, at);
+            glm::vec2 texCoordMin((float)al, (float)ab);
+            glm::vec2 texCoordMax((float)ar, (float)at);
+
             texCoordMin *= glm::vec2(texelWidth, texelHeight);
             texCoordMax *= glm::vec2(texelWidth, texelHeight);
 
@@ -641,15 +1056,20 @@ namespace oak {
 
             s_Data.textIndexCount += 6;
             s_Data.stats.quadCount++;
+        });
+    }
 
-            if (i < string.size() - 1) {
-                auto advance = glyph->getAdvance();
-                auto nextCharacter = string[i + 1];
-                fontGeometry.getAdvance(advance, character, nextCharacter);
+    bool Renderer2D::computeStringBounds(const std::string& string, Ref<Font> font, const TextParams& textParams, glm::vec2& min, glm::vec2& max)
+    {
+        min = glm::vec2(std::numeric_limits<float>::max());
+        max = glm::vec2(std::numeric_limits<float>::lowest());
 
-                x += fsScale * advance + textParams.kerning;
-            }
-        }
+        layoutString(string, font->getMSDFData()->fontGeometry, textParams, [&](const msdf_atlas::GlyphGeometry&, const glm::vec2& quadMin, const glm::vec2& quadMax) {
+            min = glm::min(min, quadMin);
+            max = glm::max(max, quadMax);
+        });
+
+        return min.x <= max.x;
     }
 
     void Renderer2D::drawString(const std::string& string, const glm::mat4& transform, const TextComponent& component, int entityID)
@@ -667,6 +1087,16 @@ namespace oak {
         s_Data.lineWidth = width;
     }
 
+    uint8_t Renderer2D::getSortLayer()
+    {
+        return s_Data.sortLayer;
+    }
+
+    void Renderer2D::setSortLayer(uint8_t layer)
+    {
+        s_Data.sortLayer = layer;
+    }
+
     void Renderer2D::resetStats()
     {
         memset(&s_Data.stats, 0, sizeof(Statistics));
@@ -674,6 +1104,10 @@ namespace oak {
 
     Renderer2D::Statistics Renderer2D::getStats()
     {
-        return s_Data.stats;
+        auto stats = s_Data.stats;
+        stats.atlasPageCount = (uint32_t)s_Data.textureAtlas.getPageCount();
+        stats.atlasOccupancy = s_Data.textureAtlas.getOccupancy();
+
+        return stats;
     }
 }
@@ -7,14 +7,19 @@
 #include "Oak/Renderer/Camera.hpp"
 #include "Oak/Renderer/EditorCamera.hpp"
 #include "Oak/Renderer/Font.hpp"
+#include "Oak/Renderer/Renderer2DSpecification.hpp"
 
 #include "Oak/Scene/Components.hpp"
 
+#include "entt.hpp"
+
+#include <span>
+
 namespace oak {
     class Renderer2D
     {
     public:
-        static void init();
+        static void init(const Renderer2DSpecification& specification = Renderer2DSpecification());
         static void shutdown();
 
         static void beginScene(const Camera& camera, const glm::mat4& transform);
@@ -45,6 +50,8 @@ namespace oak {
         static void drawRect(const glm::mat4& transform, const glm::vec4& color, int entityID = -1);
 
         static void drawSprite(const glm::mat4& transform, SpriteRendererComponent& src, int entityID);
+        // Batched drawSprite, transforms are computed with the SIMD kernel in Oak/Math/BatchTransform
+        static void drawQuads(std::span<const TransformComponent> transforms, std::span<const SpriteRendererComponent> sprites, std::span<const entt::entity> entities);
 
         struct TextParams
         {
@@ -54,15 +61,30 @@ namespace oak {
         };
         static void drawString(const std::string& string, Ref<Font> font, const glm::mat4& transform, const TextParams& textParams, int entityID = -1);
         static void drawString(const std::string& string, const glm::mat4& transform, const TextComponent& component, int entityID = -1);
+        // Local-space bounds of the glyph quads drawString would emit, false when there are none
+        static bool computeStringBounds(const std::string& string, Ref<Font> font, const TextParams& textParams, glm::vec2& min, glm::vec2& max);
 
         static float getLineWidth();
         static void setLineWidth(float width);
 
+        // Quads and circles are sorted by layer first, then back to front. Reset to 0 by beginScene.
+        // Lines and text are not sorted, they are drawn after all quads and circles of their batch in submission order
+        static uint8_t getSortLayer();
+        static void setSortLayer(uint8_t layer);
+
         // Stats
         struct Statistics
         {
             uint32_t drawCalls = 0;
             uint32_t quadCount = 0;
+            // Submitted quads and circles, one per draw call made by the scene
+            uint32_t visibleCount = 0;
+            uint32_t culledCount = 0;
+            uint32_t culledGlyphCount = 0; // Text is culled per glyph, kept apart so it does not skew the counts above
+
+            // Texture atlas, persistent across frames
+            uint32_t atlasPageCount = 0;
+            float atlasOccupancy = 0.0f;
 
             uint32_t getTotalVertexCount() const { return quadCount * 4; }
             uint32_t getTotalIndexCount() const { return quadCount * 6; }
@@ -73,5 +95,10 @@ namespace oak {
     private:
         static void startBatch();
         static void nextBatch();
+        // Sorts the queued quads and circles and writes their vertices
+        static void drawQueue();
+
+        // Texture slot in the current batch and layer within it, may start a new batch when the slots are full
+        static glm::vec2 getTextureSlot(const Ref<Texture2D>& texture);
     };
 }
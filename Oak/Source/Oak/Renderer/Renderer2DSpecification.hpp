@@ -0,0 +1,23 @@
+#pragma once
+
+namespace oak {
+    enum class QuadPipeline
+    {
+        // Four vertices per quad, corners transformed on the CPU
+        Vertex = 0,
+        // One instance record per quad, corners expanded in the vertex shader
+        Instanced
+    };
+
+    struct Renderer2DSpecification
+    {
+        QuadPipeline quadPipeline = QuadPipeline::Vertex;
+        // Skip quads, circles and glyphs outside the camera's view volume before their vertices are written
+        bool frustumCulling = true;
+        // Sample quad textures from array layers grouped by size and format, so a batch is limited
+        // by 32 distinct sizes instead of 32 distinct textures
+        bool textureArrays = false;
+        // Pack small RGBA8 sprite textures into shared atlas pages and remap their UVs. Ignored with textureArrays
+        bool textureAtlas = false;
+    };
+}
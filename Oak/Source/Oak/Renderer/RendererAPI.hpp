@@ -20,8 +20,9 @@ namespace oak {
         virtual void setClearColor(const glm::vec4& color) = 0;
         virtual void clear() = 0;
 
-        virtual void drawIndexed(const Ref<VertexArray>& vertexArray, uint32_t indexCount = 0) = 0;
-        virtual void drawLines(const Ref<VertexArray>& vertexArray, uint32_t vertexCount) = 0;
+        virtual void drawIndexed(const Ref<VertexArray>& vertexArray, uint32_t indexCount = 0, uint32_t baseVertex = 0) = 0;
+        virtual void drawIndexedInstanced(const Ref<VertexArray>& vertexArray, uint32_t indexCount, uint32_t instanceCount, uint32_t baseInstance = 0) = 0;
+        virtual void drawLines(const Ref<VertexArray>& vertexArray, uint32_t vertexCount, uint32_t firstVertex = 0) = 0;
         
         virtual void setLineWidth(float width) = 0;
 
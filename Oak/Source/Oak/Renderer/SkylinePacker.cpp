@@ -0,0 +1,161 @@
+#include "oakpch.hpp"
+#include "Oak/Renderer/SkylinePacker.hpp"
+
+namespace oak {
+    SkylinePacker::SkylinePacker(uint32_t width, uint32_t height) : m_Width{ width }, m_Height{ height }
+    {
+        reset();
+    }
+
+    void SkylinePacker::reset()
+    {
+        m_UsedArea = 0;
+        m_Skyline.clear();
+        m_Skyline.push_back({ 0, 0, m_Width });
+        m_FreeRects.clear();
+    }
+
+    void SkylinePacker::release(const glm::uvec2& position, uint32_t width, uint32_t height)
+    {
+        OAK_CORE_ASSERT(m_UsedArea >= (uint64_t)width * height, "Released more area than was packed!");
+
+        m_UsedArea -= (uint64_t)width * height;
+
+        // Nothing left, start over with a flat skyline instead of a fragmented free list
+        if (m_UsedArea == 0) {
+            reset();
+            return;
+        }
+
+        m_FreeRects.push_back({ position.x, position.y, width, height });
+    }
+
+    std::optional<glm::uvec2> SkylinePacker::packFree(uint32_t width, uint32_t height)
+    {
+        // Smallest free rectangle that fits, so large holes stay available for large requests
+        size_t bestIndex = m_FreeRects.size();
+        uint64_t bestArea = UINT64_MAX;
+        for (size_t i = 0; i < m_FreeRects.size(); i++) {
+            const auto& rect = m_FreeRects[i];
+            const auto area = (uint64_t)rect.width * rect.height;
+            if (rect.width >= width && rect.height >= height && area < bestArea) {
+                bestIndex = i;
+                bestArea = area;
+            }
+        }
+
+        if (bestIndex == m_FreeRects.size()) {
+            return std::nullopt;
+        }
+
+        const auto rect = m_FreeRects[bestIndex];
+        m_FreeRects[bestIndex] = m_FreeRects.back();
+        m_FreeRects.pop_back();
+
+        // Guillotine split of what is left, the strip to the right keeps the full height of the hole
+        if (rect.width > width) {
+            m_FreeRects.push_back({ rect.x + width, rect.y, rect.width - width, rect.height });
+        }
+        if (rect.height > height) {
+            m_FreeRects.push_back({ rect.x, rect.y + height, width, rect.height - height });
+        }
+
+        return glm::uvec2{ rect.x, rect.y };
+    }
+
+    std::optional<uint32_t> SkylinePacker::fit(size_t index, uint32_t width, uint32_t height) const
+    {
+        const auto x = m_Skyline[index].x;
+        if (x + width > m_Width) {
+            return std::nullopt;
+        }
+
+        // The rectangle rests on the highest segment it spans
+        uint32_t y = 0;
+        uint32_t remaining = width;
+        for (auto i = index; remaining > 0; i++) {
+            OAK_CORE_ASSERT(i < m_Skyline.size(), "Skyline does not cover the packer width!");
+
+            y = std::max(y, m_Skyline[i].y);
+            if (y + height > m_Height) {
+                return std::nullopt;
+            }
+
+            remaining -= std::min(remaining, m_Skyline[i].width);
+        }
+
+        return y;
+    }
+
+    std::optional<glm::uvec2> SkylinePacker::pack(uint32_t width, uint32_t height)
+    {
+        if (width == 0 || height == 0) {
+            return std::nullopt;
+        }
+
+        if (const auto position = packFree(width, height)) {
+            m_UsedArea += (uint64_t)width * height;
+            return position;
+        }
+
+        // Lowest top edge wins, ties go to the narrowest segment to keep the skyline flat
+        size_t bestIndex = m_Skyline.size();
+        uint32_t bestTop = UINT32_MAX;
+        uint32_t bestWidth = UINT32_MAX;
+        uint32_t bestY = 0;
+        for (size_t i = 0; i < m_Skyline.size(); i++) {
+            const auto y = fit(i, width, height);
+            if (!y) {
+                continue;
+            }
+
+            const auto top = *y + height;
+            if (top < bestTop || (top == bestTop && m_Skyline[i].width < bestWidth)) {
+                bestIndex = i;
+                bestTop = top;
+                bestWidth = m_Skyline[i].width;
+                bestY = *y;
+            }
+        }
+
+        if (bestIndex == m_Skyline.size()) {
+            return std::nullopt;
+        }
+
+        const glm::uvec2 position{ m_Skyline[bestIndex].x, bestY };
+        m_Skyline.insert(m_Skyline.begin() + bestIndex, { position.x, bestTop, width });
+
+        // Trim the segments now covered by the new one
+        const auto right = position.x + width;
+        for (auto i = bestIndex + 1; i < m_Skyline.size();) {
+            auto& node = m_Skyline[i];
+            if (node.x >= right) {
+                break;
+            }
+
+            const auto nodeRight = node.x + node.width;
+            if (nodeRight <= right) {
+                m_Skyline.erase(m_Skyline.begin() + i);
+                continue;
+            }
+
+            node.width = nodeRight - right;
+            node.x = right;
+            break;
+        }
+
+        // Merge neighbours at the same height
+        for (size_t i = 0; i + 1 < m_Skyline.size();) {
+            if (m_Skyline[i].y == m_Skyline[i + 1].y) {
+                m_Skyline[i].width += m_Skyline[i + 1].width;
+                m_Skyline.erase(m_Skyline.begin() + i + 1);
+            }
+            else {
+                i++;
+            }
+        }
+
+        m_UsedArea += (uint64_t)width * height;
+        return position;
+    }
+}
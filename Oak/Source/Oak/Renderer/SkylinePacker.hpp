@@ -0,0 +1,53 @@
+#pragma once
+
+#include <glm/glm.hpp>
+
+#include <optional>
+#include <vector>
+
+namespace oak {
+    // Bottom-left skyline rectangle packer. Pure CPU bookkeeping, the caller copies the pixels.
+    // Released rectangles are kept in a free list and reused before the skyline grows
+    class SkylinePacker
+    {
+    public:
+        SkylinePacker(uint32_t width, uint32_t height);
+
+        // Position of the bottom-left corner of the packed rectangle, or nothing when it does not fit
+        std::optional<glm::uvec2> pack(uint32_t width, uint32_t height);
+        // Gives back a rectangle returned by pack, with the same size it was packed with
+        void release(const glm::uvec2& position, uint32_t width, uint32_t height);
+        void reset();
+
+        uint32_t getWidth() const { return m_Width; }
+        uint32_t getHeight() const { return m_Height; }
+        // Packed area that was not released, over total area
+        float getOccupancy() const { return (float)m_UsedArea / (float)((uint64_t)m_Width * m_Height); }
+
+    private:
+        // Height of the skyline segment starting at node `index` if a rectangle of `width` was placed there
+        std::optional<uint32_t> fit(size_t index, uint32_t width, uint32_t height) const;
+        std::optional<glm::uvec2> packFree(uint32_t width, uint32_t height);
+
+    private:
+        struct Node
+        {
+            uint32_t x;
+            uint32_t y;
+            uint32_t width;
+        };
+
+        struct FreeRect
+        {
+            uint32_t x;
+            uint32_t y;
+            uint32_t width;
+            uint32_t height;
+        };
+
+        uint32_t m_Width, m_Height;
+        uint64_t m_UsedArea = 0;
+        std::vector<Node> m_Skyline;
+        std::vector<FreeRect> m_FreeRects; // Released space below the skyline
+    };
+}
@@ -33,4 +33,18 @@ namespace oak {
         OAK_CORE_ASSERT(false, "Unknown RendererAPI!");
         return nullptr;
     }
+
+    Ref<Texture2DArray> Texture2DArray::create(const TextureSpecification& specification, uint32_t layerCount)
+    {
+        switch (Renderer::getAPI()) {
+            case RendererAPI::API::None:
+                OAK_CORE_ASSERT(false, "RendererAPI::None is currently not supported!");
+                return nullptr;
+            case RendererAPI::API::OpenGL:
+                return createRef<opengl::Texture2DArray>(specification, layerCount);
+        }
+
+        OAK_CORE_ASSERT(false, "Unknown RendererAPI!");
+        return nullptr;
+    }
 }
@@ -36,6 +36,8 @@ namespace oak {
         virtual const std::string& getPath() const = 0;
 
         virtual void setData(void* data, uint32_t size) = 0;
+        // GPU side copy of a rectangle of a texture with a compatible format, the source may be this texture
+        virtual void copyRegion(const Texture& source, uint32_t sourceX, uint32_t sourceY, uint32_t x, uint32_t y, uint32_t width, uint32_t height) = 0;
 
         virtual void bind(uint32_t slot = 0) const = 0;
 
@@ -50,4 +52,24 @@ namespace oak {
         static Ref<Texture2D> create(const TextureSpecification& specification);
         static Ref<Texture2D> create(const std::string& path);
     };
+
+    // Layers of equally sized textures sampled through a single binding
+    class Texture2DArray
+    {
+    public:
+        virtual ~Texture2DArray() = default;
+
+        virtual const TextureSpecification& getSpecification() const = 0;
+        virtual uint32_t getLayerCount() const = 0;
+        virtual uint32_t getRendererID() const = 0;
+
+        // GPU side copy of a texture with the array's size and format into a layer
+        virtual void copyToLayer(uint32_t layer, const Texture2D& texture) = 0;
+        // GPU side copy of the first `count` layers of another array with the same size and format
+        virtual void copyLayers(const Texture2DArray& source, uint32_t count) = 0;
+
+        virtual void bind(uint32_t slot = 0) const = 0;
+
+        static Ref<Texture2DArray> create(const TextureSpecification& specification, uint32_t layerCount);
+    };
 }
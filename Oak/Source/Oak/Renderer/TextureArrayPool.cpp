@@ -0,0 +1,121 @@
+#include "oakpch.hpp"
+#include "Oak/Renderer/TextureArrayPool.hpp"
+
+#include <optional>
+
+namespace oak {
+    static bool isSameOwner(const std::weak_ptr<Texture2D>& a, const Ref<Texture2D>& b)
+    {
+        return !a.owner_before(b) && !b.owner_before(a);
+    }
+
+    static bool isCompatible(const TextureSpecification& a, const TextureSpecification& b)
+    {
+        return a.width == b.width && a.height == b.height && a.format == b.format;
+    }
+
+    TextureArrayPool::Location TextureArrayPool::acquire(const Ref<Texture2D>& texture)
+    {
+        const auto rendererID = texture->getRendererID();
+
+        auto it = m_Entries.find(rendererID);
+        if (it != m_Entries.end()) {
+            if (isSameOwner(it->second.texture, texture)) {
+                return it->second.location;
+            }
+
+            // The renderer ID was reused after the previous texture was deleted
+            const auto& stale = it->second.location;
+            m_Arrays[stale.array].freeLayers.push_back(stale.layer);
+            m_Entries.erase(it);
+        }
+
+        const auto arrayIndex = findArray(texture->getSpecification());
+        auto& page = m_Arrays[arrayIndex];
+
+        uint32_t layer;
+        if (!page.freeLayers.empty()) {
+            layer = page.freeLayers.back();
+            page.freeLayers.pop_back();
+        }
+        else {
+            layer = page.usedLayers++;
+        }
+
+        page.array->copyToLayer(layer, *texture);
+
+        const Location location{ arrayIndex, layer };
+        m_Entries[rendererID] = { texture, location };
+        return location;
+    }
+
+    void TextureArrayPool::clear()
+    {
+        m_Entries.clear();
+        m_Arrays.clear();
+    }
+
+    uint32_t TextureArrayPool::findArray(const TextureSpecification& specification)
+    {
+        const auto hasRoom = [](const ArrayPage& page) {
+            return !page.freeLayers.empty() || page.usedLayers < page.array->getLayerCount();
+        };
+
+        const auto findWithRoom = [&]() -> std::optional<uint32_t> {
+            for (uint32_t i = 0; i < m_Arrays.size(); i++) {
+                if (isCompatible(m_Arrays[i].array->getSpecification(), specification) && hasRoom(m_Arrays[i])) {
+                    return i;
+                }
+            }
+            return std::nullopt;
+        };
+
+        if (auto index = findWithRoom()) {
+            return *index;
+        }
+
+        // Reclaim layers of deleted textures before allocating more memory
+        collectExpired();
+        if (auto index = findWithRoom()) {
+            return *index;
+        }
+
+        // Grow a full array by reallocating it at twice the size, its layer indices stay valid
+        for (uint32_t i = 0; i < m_Arrays.size(); i++) {
+            auto& page = m_Arrays[i];
+            const auto layerCount = page.array->getLayerCount();
+            if (!isCompatible(page.array->getSpecification(), specification) || layerCount >= maxLayerCount) {
+                continue;
+            }
+
+            auto grown = Texture2DArray::create(page.array->getSpecification(), std::min(layerCount * 2, maxLayerCount));
+            grown->copyLayers(*page.array, page.usedLayers);
+            page.array = grown;
+            return i;
+        }
+
+        TextureSpecification arraySpecification;
+        arraySpecification.width = specification.width;
+        arraySpecification.height = specification.height;
+        arraySpecification.format = specification.format;
+        arraySpecification.generateMips = false;
+
+        auto& page = m_Arrays.emplace_back();
+        page.array = Texture2DArray::create(arraySpecification, initialLayerCount);
+        return (uint32_t)(m_Arrays.size() - 1);
+    }
+
+    void TextureArrayPool::collectExpired()
+    {
+        for (auto it = m_Entries.begin(); it != m_Entries.end();) {
+            if (it->second.texture.expired()) {
+                const auto& location = it->second.location;
+                m_Arrays[location.array].freeLayers.push_back(location.layer);
+                it = m_Entries.erase(it);
+            }
+            else {
+                ++it;
+            }
+        }
+    }
+}
@@ -0,0 +1,51 @@
+#pragma once
+
+#include "Oak/Renderer/Texture.hpp"
+
+#include <unordered_map>
+#include <vector>
+
+namespace oak {
+    // Copies 2D textures into array layers, grouped by size and format, so many textures share one sampler binding.
+    // A texture is copied the first time it is acquired, later setData calls on it are not picked up
+    class TextureArrayPool
+    {
+    public:
+        struct Location
+        {
+            uint32_t array;
+            uint32_t layer;
+        };
+
+        Location acquire(const Ref<Texture2D>& texture);
+
+        const Ref<Texture2DArray>& getArray(uint32_t index) const { return m_Arrays[index].array; }
+        size_t getArrayCount() const { return m_Arrays.size(); }
+
+        void clear();
+
+    private:
+        uint32_t findArray(const TextureSpecification& specification);
+        void collectExpired();
+
+    private:
+        static constexpr uint32_t initialLayerCount = 16;
+        static constexpr uint32_t maxLayerCount = 256; // GL 4.5 guarantees at least 2048
+
+        struct Entry
+        {
+            std::weak_ptr<Texture2D> texture;
+            Location location;
+        };
+
+        struct ArrayPage
+        {
+            Ref<Texture2DArray> array;
+            uint32_t usedLayers = 0;
+            std::vector<uint32_t> freeLayers;
+        };
+
+        std::unordered_map<uint32_t, Entry> m_Entries; // Texture renderer ID to its layer
+        std::vector<ArrayPage> m_Arrays;
+    };
+}
@@ -0,0 +1,175 @@
+#include "oakpch.hpp"
+#include "Oak/Renderer/TextureAtlas.hpp"
+
+namespace oak {
+    static bool isSameOwner(const std::weak_ptr<Texture2D>& a, const Ref<Texture2D>& b)
+    {
+        return !a.owner_before(b) && !b.owner_before(a);
+    }
+
+    const TextureAtlas::Region* TextureAtlas::acquire(const Ref<Texture2D>& texture)
+    {
+        const auto rendererID = texture->getRendererID();
+        if (const auto it = m_Entries.find(rendererID); it != m_Entries.end() && isSameOwner(it->second.texture, texture)) {
+            return it->second.region ? &*it->second.region : nullptr;
+        }
+
+        // A stale entry means the renderer ID was reused, the destroyed texture's area goes back to its page
+        auto& entry = m_Entries[rendererID];
+        releaseRegion(entry);
+        entry.texture = texture;
+
+        if (!isPackable(*texture)) {
+            return nullptr;
+        }
+
+        const auto width = texture->getWidth();
+        const auto height = texture->getHeight();
+
+        glm::uvec2 position;
+        auto* page = pack(width + padding * 2, height + padding * 2, position);
+
+        // Space given back by destroyed textures is cheaper than a new page
+        if (!page && releaseExpired()) {
+            page = pack(width + padding * 2, height + padding * 2, position);
+        }
+
+        if (!page) {
+            TextureSpecification specification;
+            specification.width = pageSize;
+            specification.height = pageSize;
+            specification.format = ImageFormat::RGBA8;
+            specification.generateMips = false;
+
+            page = &m_Pages.emplace_back();
+            page->texture = Texture2D::create(specification);
+
+            const auto packed = page->packer.pack(width + padding * 2, height + padding * 2);
+            OAK_CORE_ASSERT(packed, "Texture does not fit in an empty atlas page!");
+            position = *packed;
+        }
+
+        page->regionCount++;
+        entry.position = position;
+        entry.size = { width + padding * 2, height + padding * 2 };
+
+        const auto x = position.x + padding;
+        const auto y = position.y + padding;
+        auto& pageTexture = *page->texture;
+        pageTexture.copyRegion(*texture, 0, 0, x, y, width, height);
+
+        // Extrude the edge columns, then the edge rows including the new columns, so the corners are filled too
+        for (uint32_t i = 0; i < padding; i++) {
+            pageTexture.copyRegion(*texture, 0, 0, position.x + i, y, 1, height);
+            pageTexture.copyRegion(*texture, width - 1, 0, x + width + i, y, 1, height);
+        }
+        for (uint32_t i = 0; i < padding; i++) {
+            pageTexture.copyRegion(pageTexture, position.x, y, position.x, position.y + i, width + padding * 2, 1);
+            pageTexture.copyRegion(pageTexture, position.x, y + height - 1, position.x, y + height + i, width + padding * 2, 1);
+        }
+
+        const auto uvMin = glm::vec2(x, y) / (float)pageSize;
+        const auto uvMax = glm::vec2(x + width, y + height) / (float)pageSize;
+        entry.region = Region{ page->texture, { uvMin, uvMax } };
+
+        return &*entry.region;
+    }
+
+    TextureAtlas::Page* TextureAtlas::pack(uint32_t width, uint32_t height, glm::uvec2& position)
+    {
+        for (auto& page : m_Pages) {
+            if (const auto packed = page.packer.pack(width, height)) {
+                position = *packed;
+                return &page;
+            }
+        }
+
+        return nullptr;
+    }
+
+    void TextureAtlas::releaseRegion(Entry& entry)
+    {
+        if (!entry.region) {
+            return;
+        }
+
+        for (auto& page : m_Pages) {
+            if (page.texture == entry.region->page) {
+                page.packer.release(entry.position, entry.size.x, entry.size.y);
+                page.regionCount--;
+                break;
+            }
+        }
+
+        entry.region.reset();
+    }
+
+    bool TextureAtlas::releaseExpired()
+    {
+        auto released = false;
+        for (auto it = m_Entries.begin(); it != m_Entries.end();) {
+            if (it->second.texture.expired()) {
+                releaseRegion(it->second);
+                it = m_Entries.erase(it);
+                released = true;
+            }
+            else {
+                ++it;
+            }
+        }
+
+        // Batches that still sample a dropped page keep it alive until they are drawn
+        std::erase_if(m_Pages, [](const Page& page) { return page.regionCount == 0; });
+
+        return released;
+    }
+
+    void TextureAtlas::update()
+    {
+        if (++m_UpdateCount % collectInterval == 0) {
+            collect();
+        }
+    }
+
+    void TextureAtlas::collect()
+    {
+        OAK_PROFILE_FUNCTION();
+
+        releaseExpired();
+
+        // The live regions would fit in fewer pages, each texture is copied into a fresh page on its next acquire
+        if (m_Pages.size() > 1 && getOccupancy() < repackOccupancy) {
+            clear();
+        }
+    }
+
+    void TextureAtlas::clear()
+    {
+        m_Entries.clear();
+        m_Pages.clear();
+    }
+
+    float TextureAtlas::getOccupancy() const
+    {
+        if (m_Pages.empty()) {
+            return 0.0f;
+        }
+
+        auto occupancy = 0.0f;
+        for (const auto& page : m_Pages) {
+            occupancy += page.packer.getOccupancy();
+        }
+
+        return occupancy / (float)m_Pages.size();
+    }
+
+    bool TextureAtlas::isPackable(const Texture2D& texture) const
+    {
+        const auto& specification = texture.getSpecification();
+
+        return texture.getRendererID() != 0
+            && specification.format == ImageFormat::RGBA8
+            && texture.getWidth() <= maxTextureSize
+            && texture.getHeight() <= maxTextureSize;
+    }
+}
@@ -0,0 +1,72 @@
+#pragma once
+
+#include "Oak/Renderer/Texture.hpp"
+#include "Oak/Renderer/SkylinePacker.hpp"
+
+#include <glm/glm.hpp>
+
+#include <optional>
+#include <unordered_map>
+#include <vector>
+
+namespace oak {
+    // Packs small RGBA8 textures into shared pages so sprites using them batch together.
+    // Each texture is surrounded by a border of its own edge pixels so filtering never reads a neighbour.
+    // A texture is copied the first time it is acquired, later setData calls on it are not picked up.
+    // Regions of destroyed textures are given back to their page, and pages nothing lives in are freed
+    class TextureAtlas
+    {
+    public:
+        static constexpr uint32_t pageSize = 2048;
+        static constexpr uint32_t maxTextureSize = 256;
+        static constexpr uint32_t padding = 2;
+        static constexpr uint32_t collectInterval = 120; // Calls to update between sweeps for destroyed textures
+        static constexpr float repackOccupancy = 0.5f; // Below this the pages are emptied and refilled on demand
+
+        struct Region
+        {
+            Ref<Texture2D> page;
+            glm::vec4 texRect; // UV min (xy) and max (zw) within the page
+        };
+
+        // Null when the texture is too large or has a format the pages cannot hold
+        const Region* acquire(const Ref<Texture2D>& texture);
+
+        // Call once per scene, sweeps for destroyed textures every collectInterval calls
+        void update();
+        // Frees the regions of destroyed textures and the pages left empty, repacks when the pages are mostly unused
+        void collect();
+        void clear();
+
+        size_t getPageCount() const { return m_Pages.size(); }
+        // Packed texture area, including borders, over the area of all pages
+        float getOccupancy() const;
+
+    private:
+        struct Page
+        {
+            Ref<Texture2D> texture;
+            SkylinePacker packer{ pageSize, pageSize };
+            uint32_t regionCount = 0;
+        };
+
+        struct Entry
+        {
+            std::weak_ptr<Texture2D> texture;
+            std::optional<Region> region; // Unpackable textures are remembered too
+            glm::uvec2 position{ 0 }; // Packed rectangle including the border, given back when the texture is gone
+            glm::uvec2 size{ 0 };
+        };
+
+        bool isPackable(const Texture2D& texture) const;
+        Page* pack(uint32_t width, uint32_t height, glm::uvec2& position);
+        void releaseRegion(Entry& entry);
+        // False when no texture was destroyed since the last sweep
+        bool releaseExpired();
+
+    private:
+        std::unordered_map<uint32_t, Entry> m_Entries; // Texture renderer ID to its region
+        std::vector<Page> m_Pages;
+        uint32_t m_UpdateCount = 0;
+    };
+}
@@ -14,6 +14,8 @@ namespace oak {
         virtual void unbind() const = 0;
 
         virtual void addVertexBuffer(const Ref<VertexBuffer>& vertexBuffer) = 0;
+        // Every attribute of the buffer advances once per instance instead of once per vertex
+        virtual void addInstanceBuffer(const Ref<VertexBuffer>& instanceBuffer) = 0;
         virtual void setIndexBuffer(const Ref<IndexBuffer>& indexBuffer) = 0;
 
         virtual const std::vector<Ref<VertexBuffer>>& getVertexBuffers() const = 0;
@@ -35,20 +35,115 @@ namespace oak {
 
     struct TransformComponent
     {
-        glm::vec3 translation = { 0.0f, 0.0f, 0.0f };
-        glm::vec3 rotation = { 0.0f, 0.0f, 0.0f };
-        glm::vec3 scale = { 1.0f, 1.0f, 1.0f };
-
         TransformComponent() = default;
         TransformComponent(const TransformComponent&) = default;
-        TransformComponent(const glm::vec3& t_translation): translation(t_translation) {}
+        // The registry moves components between slots, a move keeps the change log attached
+        TransformComponent(TransformComponent&&) = default;
+        TransformComponent& operator=(const TransformComponent&) = default;
+        TransformComponent& operator=(TransformComponent&&) = default;
+        TransformComponent(const glm::vec3& t_translation): m_Translation(t_translation) {}
+
+        const glm::vec3& getTranslation() const { return m_Translation; }
+        void setTranslation(const glm::vec3& t_translation) { m_Translation = t_translation; m_Dirty = true; m_Version++; markChanged(); }
+
+        const glm::vec3& getRotation() const { return m_Rotation; }
+        void setRotation(const glm::vec3& t_rotation) { m_Rotation = t_rotation; m_Dirty = true; m_Version++; markChanged(); }
+
+        const glm::vec3& getScale() const { return m_Scale; }
+        void setScale(const glm::vec3& t_scale) { m_Scale = t_scale; m_Dirty = true; m_Version++; markChanged(); }
+
+        bool isDirty() const { return m_Dirty; }
+        // Bumped by every setter, lets the hierarchy pass skip subtrees that did not move
+        uint32_t getVersion() const { return m_Version; }
+
+        // The matrix is cached and only rebuilt after one of the setters was called
+        const glm::mat4& getTransform() const
+        {
+            if (m_Dirty) {
+                glm::mat4 rotation = glm::toMat4(glm::quat(m_Rotation));
+
+                setCachedTransform(glm::translate(glm::mat4(1.0f), m_Translation) * rotation * glm::scale(glm::mat4(1.0f), m_Scale));
+            }
+
+            return m_Transform;
+        }
+
+        // For batched updates that rebuilt the matrix outside of getTransform
+        void setCachedTransform(const glm::mat4& t_transform) const
+        {
+            m_Transform = t_transform;
+            m_Dirty = false;
+        }
+
+        // Parented transforms get their world matrix from Scene's hierarchy pass, roots use the local matrix
+        const glm::mat4& getWorldTransform() const { return m_HasParent ? m_WorldTransform : getTransform(); }
+        bool hasParent() const { return m_HasParent; }
+
+        void setWorldTransform(const glm::mat4& t_transform)
+        {
+            m_WorldTransform = t_transform;
+            m_HasParent = true;
+            markChanged();
+        }
 
-        glm::mat4 getTransform() const
+        void resetWorldTransform() { m_HasParent = false; markChanged(); }
+
+        // Scene hands each transform a log to record its entity in, at most once until the log is drained
+        void attachChangeLog(std::vector<uint32_t>* log, uint32_t handle)
         {
-            glm::mat4 rotationTemp = glm::toMat4(glm::quat(rotation));
+            m_ChangeLog.entries = log;
+            m_ChangeLog.handle = handle;
+            m_ChangeLog.logged = false;
+            markChanged();
+        }
 
-            return glm::translate(glm::mat4(1.0f), translation) * rotationTemp * glm::scale(glm::mat4(1.0f), scale);
+        void markChanged()
+        {
+            if (m_ChangeLog.entries && !m_ChangeLog.logged) {
+                m_ChangeLog.entries->push_back(m_ChangeLog.handle);
+                m_ChangeLog.logged = true;
+            }
         }
+
+        void clearChanged() { m_ChangeLog.logged = false; }
+
+    private:
+        glm::vec3 m_Translation = { 0.0f, 0.0f, 0.0f };
+        glm::vec3 m_Rotation = { 0.0f, 0.0f, 0.0f };
+        glm::vec3 m_Scale = { 1.0f, 1.0f, 1.0f };
+
+        mutable glm::mat4 m_Transform{ 1.0f };
+        mutable bool m_Dirty = true;
+        uint32_t m_Version = 0;
+
+        glm::mat4 m_WorldTransform{ 1.0f };
+        bool m_HasParent = false;
+
+        // Belongs to the entity, copies start detached until Scene attaches them while moves carry it along
+        struct ChangeLog
+        {
+            std::vector<uint32_t>* entries = nullptr;
+            uint32_t handle = 0;
+            bool logged = false;
+
+            ChangeLog() = default;
+            ChangeLog(const ChangeLog&) {}
+            ChangeLog(ChangeLog&&) = default;
+            ChangeLog& operator=(const ChangeLog&) { return *this; }
+            ChangeLog& operator=(ChangeLog&&) = default;
+        };
+
+        ChangeLog m_ChangeLog;
+    };
+
+    // Links an entity into the scene hierarchy. A parent of 0 means the entity is a root
+    struct RelationshipComponent
+    {
+        UUID parent = 0;
+        std::vector<UUID> children;
+
+        RelationshipComponent() = default;
+        RelationshipComponent(const RelationshipComponent&) = default;
     };
 
     struct SpriteRendererComponent
@@ -38,6 +38,14 @@ namespace oak {
             return m_Scene->m_Registry.get<T>(m_EntityHandle);
         }
 
+        // Edits the component in place and runs the scene's update hooks for it
+        template<typename T, typename... Func>
+        T& patchComponent(Func&&... func)
+        {
+            OAK_CORE_ASSERT(hasComponent<T>(), "Entity does not have component!");
+            return m_Scene->m_Registry.patch<T>(m_EntityHandle, std::forward<Func>(func)...);
+        }
+
         template<typename T>
         bool hasComponent()
         {
@@ -4,9 +4,13 @@
 
 #include "Components.hpp"
 #include "ScriptableEntity.hpp"
+#include "SpatialIndex.hpp"
 #include "Oak/Scripting/ScriptEngine.hpp"
 #include "Oak/Renderer/Renderer2D.hpp"
 #include "Oak/Physics/Physics2D.hpp"
+#include "Oak/Physics/PhysicsThread.hpp"
+#include "Oak/Project/Project.hpp"
+#include "Oak/Math/Math.hpp"
 
 #include <glm/glm.hpp>
 
@@ -22,11 +26,42 @@
 namespace oak {
     Scene::Scene()
     {
+        m_SpatialIndex = createScope<SpatialIndex>();
+
+        m_Registry.on_construct<Rigidbody2DComponent>().connect<&Scene::onRigidbody2DConstruct>(*this);
+        m_Registry.on_destroy<Rigidbody2DComponent>().connect<&Scene::onRigidbody2DDestroy>(*this);
+        m_Registry.on_construct<BoxCollider2DComponent>().connect<&Scene::onCollider2DConstruct<BoxCollider2DComponent>>(*this);
+        m_Registry.on_destroy<BoxCollider2DComponent>().connect<&Scene::onCollider2DDestroy<BoxCollider2DComponent>>(*this);
+        m_Registry.on_construct<CircleCollider2DComponent>().connect<&Scene::onCollider2DConstruct<CircleCollider2DComponent>>(*this);
+        m_Registry.on_destroy<CircleCollider2DComponent>().connect<&Scene::onCollider2DDestroy<CircleCollider2DComponent>>(*this);
+        m_Registry.on_construct<TransformComponent>().connect<&Scene::onTransformConstruct>(*this);
+        m_Registry.on_update<TransformComponent>().connect<&Scene::onTransformConstruct>(*this);
+        m_Registry.on_construct<SpriteRendererComponent>().connect<&Scene::onRenderableChange>(*this);
+        m_Registry.on_construct<CircleRendererComponent>().connect<&Scene::onRenderableChange>(*this);
+        m_Registry.on_construct<TextComponent>().connect<&Scene::onRenderableChange>(*this);
+        m_Registry.on_update<TextComponent>().connect<&Scene::onRenderableChange>(*this);
+        m_Registry.on_destroy<SpriteRendererComponent>().connect<&Scene::onRenderableDestroy>(*this);
+        m_Registry.on_destroy<CircleRendererComponent>().connect<&Scene::onRenderableDestroy>(*this);
+        m_Registry.on_destroy<TextComponent>().connect<&Scene::onRenderableDestroy>(*this);
     }
 
     Scene::~Scene()
     {
+        // The registry outlives this body, its destroy hooks must not touch the world
+        m_PhysicsThread.reset();
         delete m_PhysicsWorld;
+        m_PhysicsWorld = nullptr;
+        m_SpatialIndex.reset();
+    }
+
+    static size_t entityIndex(entt::entity entity)
+    {
+        return static_cast<size_t>(entt::registry::entity(entity));
+    }
+
+    static glm::mat4 composeTransform(const glm::vec3& translation, const glm::vec3& rotation, const glm::vec3& scale)
+    {
+        return glm::translate(glm::mat4(1.0f), translation) * glm::toMat4(glm::quat(rotation)) * glm::scale(glm::mat4(1.0f), scale);
     }
 
     template<typename... Component>
@@ -87,6 +122,8 @@ namespace oak {
 
         // Copy components (except IDComponent and TagComponent)
         copyComponent(AllComponents{}, dstSceneRegistry, srcSceneRegistry, enttMap);
+        // UUIDs are preserved, so the hierarchy can be copied as is
+        copyComponent<RelationshipComponent>(dstSceneRegistry, srcSceneRegistry, enttMap);
 
         return newScene;
     }
@@ -111,6 +148,22 @@ namespace oak {
 
     void Scene::destroyEntity(Entity entity)
     {
+        if (entity.hasComponent<RelationshipComponent>()) {
+            // Copy, destroying a child edits the list
+            auto children = entity.getComponent<RelationshipComponent>().children;
+            for (auto child : children) {
+                destroyEntity(getEntityByUUID(child));
+            }
+
+            unparentEntity(entity);
+            m_TransformHierarchyDirty = true;
+        }
+
+        if (m_IsRunning && entity.hasComponent<ScriptComponent>()) {
+            ScriptEngine::onDestroyEntity(entity);
+        }
+
+        m_SpatialIndex->remove(entity);
         m_EntityMap.erase(entity.getUUID());
         m_Registry.destroy(entity);
     }
@@ -131,6 +184,9 @@ namespace oak {
                 Entity entity = { e, this };
                 ScriptEngine::onCreateEntity(entity);
             }
+
+            // Start the first frame with an empty nursery instead of paying for OnCreate garbage mid-frame
+            ScriptEngine::collectGarbage();
         }
     }
 
@@ -156,14 +212,14 @@ namespace oak {
     void Scene::onUpdateRuntime(Timestep ts)
     {
         if (!m_IsPaused || m_StepFrames-- > 0) {
+            // Results of the step started last frame, scripts may touch bodies from here on
+            syncPhysics2D();
+
             // Update scripts
             {
-                // C# Entity OnUpdate
-                auto view = m_Registry.view<ScriptComponent>();
-                for (auto e : view) {
-                    Entity entity = { e, this };
-                    ScriptEngine::onUpdateEntity(entity, ts);
-                }
+                // C# Entity OnUpdate, one managed call per script class
+                ScriptEngine::onUpdateEntities(ts);
+                ScriptEngine::onSafePoint();
 
                 m_Registry.view<NativeScriptComponent>().each([=](auto entity, auto& nsc) {
                     // TODO: Move to Scene::OnScenePlay
@@ -177,29 +233,13 @@ namespace oak {
                 });
             }
 
-            // Physics
-            {
-                const int32_t velocityIterations = 6;
-                const int32_t positionIterations = 2;
-                m_PhysicsWorld->Step(ts, velocityIterations, positionIterations);
-
-                // Retrieve transform from Box2D
-                auto view = m_Registry.view<Rigidbody2DComponent>();
-                for (auto e : view) {
-                    Entity entity = { e, this };
-                    auto& transform = entity.getComponent<TransformComponent>();
-                    auto& rb2d = entity.getComponent<Rigidbody2DComponent>();
-
-                    b2Body* body = (b2Body*)rb2d.runtimeBody;
-
-                    const auto& position = body->GetPosition();
-                    transform.translation.x = position.x;
-                    transform.translation.y = position.y;
-                    transform.rotation.z = body->GetAngle();
-                }
-            }
+            // Physics, steps on its own thread while this frame renders
+            stepPhysics2D(ts);
         }
 
+        updateTransformHierarchy();
+        updateSpatialIndex();
+
         // Render 2D
         Camera* mainCamera = nullptr;
         glm::mat4 cameraTransform;
@@ -210,7 +250,7 @@ namespace oak {
                 
                 if (camera.primary) {
                     mainCamera = &camera.camera;
-                    cameraTransform = transform.getTransform();
+                    cameraTransform = transform.getWorldTransform();
                     break;
                 }
             }
@@ -220,35 +260,7 @@ namespace oak {
         {
             Renderer2D::beginScene(*mainCamera, cameraTransform);
 
-            // Draw sprites
-            {
-                auto group = m_Registry.group<TransformComponent>(entt::get<SpriteRendererComponent>);
-                for (auto entity : group) {
-                    auto [transform, sprite] = group.get<TransformComponent, SpriteRendererComponent>(entity);
-
-                    Renderer2D::drawSprite(transform.getTransform(), sprite, (int)entity);
-                }
-            }
-
-            // Draw circles
-            {
-                auto view = m_Registry.view<TransformComponent, CircleRendererComponent>();
-                for (auto entity : view) {
-                    auto [transform, circle] = view.get<TransformComponent, CircleRendererComponent>(entity);
-
-                    Renderer2D::drawCircle(transform.getTransform(), circle.color, circle.thickness, circle.fade, (int)entity);
-                }
-            }
-
-            // Draw text
-            {
-                auto view = m_Registry.view<TransformComponent, TextComponent>();
-                for (auto entity : view) {
-                    auto [transform, text] = view.get<TransformComponent, TextComponent>(entity);
-
-                    Renderer2D::drawString(text.textString, transform.getTransform(), text, (int)entity);
-                }
-            }
+            submitRenderables(mainCamera->getProjection() * glm::inverse(cameraTransform));
 
             Renderer2D::endScene();
         }
@@ -258,26 +270,9 @@ namespace oak {
     void Scene::onUpdateSimulation(Timestep ts, EditorCamera& camera)
     {
         if (!m_IsPaused || m_StepFrames-- > 0) {
-            // Physics
-            {
-                const int32_t velocityIterations = 6;
-                const int32_t positionIterations = 2;
-                m_PhysicsWorld->Step(ts, velocityIterations, positionIterations);
-
-                // Retrieve transform from Box2D
-                auto view = m_Registry.view<Rigidbody2DComponent>();
-                for (auto e : view) {
-                    Entity entity = { e, this };
-                    auto& transform = entity.getComponent<TransformComponent>();
-                    auto& rb2d = entity.getComponent<Rigidbody2DComponent>();
-
-                    b2Body* body = (b2Body*)rb2d.runtimeBody;
-                    const auto& position = body->GetPosition();
-                    transform.translation.x = position.x;
-                    transform.translation.y = position.y;
-                    transform.rotation.z = body->GetAngle();
-                }
-            }
+            // Physics, steps on its own thread while this frame renders
+            syncPhysics2D();
+            stepPhysics2D(ts);
         }
 
         // Render
@@ -327,14 +322,220 @@ namespace oak {
     }
 
     Entity Scene::duplicateEntity(Entity entity)
+    {
+        Entity parent = {};
+        if (entity.hasComponent<RelationshipComponent>()) {
+            parent = getEntityByUUID(entity.getComponent<RelationshipComponent>().parent);
+        }
+
+        return duplicateEntityTree(entity, parent);
+    }
+
+    Entity Scene::duplicateEntityTree(Entity entity, Entity parent)
     {
         // Copy name because we're going to modify component data structure
         std::string name = entity.GetName();
         Entity newEntity = createEntity(name);
         copyComponentIfExists(AllComponents{}, newEntity, entity);
+
+        if (parent) {
+            linkEntity(newEntity, parent);
+        }
+
+        if (entity.hasComponent<RelationshipComponent>()) {
+            // Copy, duplicating may reallocate the component storage
+            auto children = entity.getComponent<RelationshipComponent>().children;
+            for (auto child : children) {
+                duplicateEntityTree(getEntityByUUID(child), newEntity);
+            }
+        }
+
         return newEntity;
     }
 
+    void Scene::parentEntity(Entity entity, Entity parent)
+    {
+        OAK_CORE_ASSERT(entity != parent, "Entity cannot be its own parent!");
+
+        if (isDescendantOf(parent, entity)) {
+            OAK_LOG_CORE_WARN("Cannot parent entity '{0}' to its own descendant '{1}'", entity.GetName(), parent.GetName());
+            return;
+        }
+
+        unparentEntity(entity);
+
+        // Re-express the world transform relative to the new parent, the entity is a root at this point
+        auto& transform = entity.getComponent<TransformComponent>();
+        glm::mat4 localTransform = glm::inverse(computeWorldTransform(parent)) * transform.getTransform();
+
+        glm::vec3 translation, rotation, scale;
+        if (math::decomposeTransform(localTransform, translation, rotation, scale)) {
+            transform.setTranslation(translation);
+            transform.setRotation(rotation);
+            transform.setScale(scale);
+        }
+
+        linkEntity(entity, parent);
+    }
+
+    void Scene::unparentEntity(Entity entity)
+    {
+        if (!entity.hasComponent<RelationshipComponent>()) {
+            return;
+        }
+
+        auto& relationship = entity.getComponent<RelationshipComponent>();
+        auto parent = getEntityByUUID(relationship.parent);
+        if (!parent) {
+            return;
+        }
+
+        // Keep the world transform, the entity becomes a root. The cached world matrix is only as fresh as
+        // the last hierarchy pass, so it is rebuilt from the parent chain
+        auto& transform = entity.getComponent<TransformComponent>();
+        glm::vec3 translation, rotation, scale;
+        if (math::decomposeTransform(computeWorldTransform(entity), translation, rotation, scale)) {
+            transform.setTranslation(translation);
+            transform.setRotation(rotation);
+            transform.setScale(scale);
+        }
+        transform.resetWorldTransform();
+
+        auto& siblings = parent.getComponent<RelationshipComponent>().children;
+        siblings.erase(std::remove(siblings.begin(), siblings.end(), entity.getUUID()), siblings.end());
+        relationship.parent = 0;
+
+        m_TransformHierarchyDirty = true;
+    }
+
+    bool Scene::isDescendantOf(Entity entity, Entity ancestor)
+    {
+        auto current = entity;
+        while (current.hasComponent<RelationshipComponent>()) {
+            auto parent = getEntityByUUID(current.getComponent<RelationshipComponent>().parent);
+            if (!parent) {
+                return false;
+            }
+            if (parent == ancestor) {
+                return true;
+            }
+            current = parent;
+        }
+
+        return false;
+    }
+
+    void Scene::linkEntity(Entity entity, Entity parent)
+    {
+        if (!entity.hasComponent<RelationshipComponent>()) {
+            entity.addComponent<RelationshipComponent>();
+        }
+        if (!parent.hasComponent<RelationshipComponent>()) {
+            parent.addComponent<RelationshipComponent>();
+        }
+
+        entity.getComponent<RelationshipComponent>().parent = parent.getUUID();
+        parent.getComponent<RelationshipComponent>().children.push_back(entity.getUUID());
+
+        m_TransformHierarchyDirty = true;
+    }
+
+    glm::mat4 Scene::computeWorldTransform(entt::entity e)
+    {
+        glm::mat4 parentTransform;
+        if (computeParentWorldTransform(e, parentTransform)) {
+            return parentTransform * m_Registry.get<TransformComponent>(e).getTransform();
+        }
+
+        return m_Registry.get<TransformComponent>(e).getTransform();
+    }
+
+    bool Scene::computeParentWorldTransform(entt::entity e, glm::mat4& outTransform)
+    {
+        auto* relationship = m_Registry.try_get<RelationshipComponent>(e);
+        if (!relationship || relationship->parent == 0) {
+            return false;
+        }
+
+        outTransform = glm::mat4(1.0f);
+        while (relationship && relationship->parent != 0) {
+            const auto parent = m_EntityMap.at(relationship->parent);
+            outTransform = m_Registry.get<TransformComponent>(parent).getTransform() * outTransform;
+            relationship = m_Registry.try_get<RelationshipComponent>(parent);
+        }
+
+        return true;
+    }
+
+    void Scene::rebuildTransformHierarchy()
+    {
+        OAK_PROFILE_FUNCTION();
+
+        m_TransformNodes.clear();
+
+        std::vector<std::pair<entt::entity, uint32_t>> stack;
+
+        auto view = m_Registry.view<RelationshipComponent>();
+        for (auto root : view) {
+            const auto& relationship = view.get<RelationshipComponent>(root);
+            if (relationship.parent != 0 || relationship.children.empty()) {
+                continue;
+            }
+
+            stack.emplace_back(root, TransformNode::noParent);
+            while (!stack.empty()) {
+                auto [entity, parentIndex] = stack.back();
+                stack.pop_back();
+
+                const auto index = (uint32_t)m_TransformNodes.size();
+                m_TransformNodes.push_back({ entity, parentIndex, 0 });
+
+                // Pushed in reverse so children keep their order in the array
+                const auto& children = m_Registry.get<RelationshipComponent>(entity).children;
+                for (auto it = children.rbegin(); it != children.rend(); it++) {
+                    stack.emplace_back(m_EntityMap.at(*it), index);
+                }
+            }
+        }
+
+        m_WorldTransforms.resize(m_TransformNodes.size());
+        m_TransformChanged.resize(m_TransformNodes.size());
+        m_TransformHierarchyDirty = false;
+    }
+
+    void Scene::updateTransformHierarchy()
+    {
+        OAK_PROFILE_FUNCTION();
+
+        const auto rebuilt = m_TransformHierarchyDirty;
+        if (rebuilt) {
+            rebuildTransformHierarchy();
+        }
+
+        // One linear pass, parents are always resolved before their children
+        for (size_t i = 0; i < m_TransformNodes.size(); i++) {
+            auto& node = m_TransformNodes[i];
+            auto& transform = m_Registry.get<TransformComponent>(node.entity);
+
+            const auto hasParent = node.parentIndex != TransformNode::noParent;
+            const auto changed = rebuilt || transform.getVersion() != node.version || (hasParent && m_TransformChanged[node.parentIndex]);
+            m_TransformChanged[i] = changed;
+            if (!changed) {
+                continue;
+            }
+
+            node.version = transform.getVersion();
+            if (hasParent) {
+                m_WorldTransforms[i] = m_WorldTransforms[node.parentIndex] * transform.getTransform();
+                // Also logs the entity for the spatial index, it may have moved only with its parent
+                transform.setWorldTransform(m_WorldTransforms[i]);
+            }
+            else {
+                m_WorldTransforms[i] = transform.getTransform();
+            }
+        }
+    }
+
     Entity Scene::findEntityByName(std::string_view name)
     {
         auto view = m_Registry.view<TagComponent>();
@@ -357,99 +558,812 @@ namespace oak {
         return {};
     }
 
+    Entity Scene::getEntityByHandle(entt::entity handle)
+    {
+        if (m_Registry.valid(handle)) {
+            return { handle, this };
+        }
+
+        return {};
+    }
+
     void Scene::onPhysics2DStart()
     {
         m_PhysicsWorld = new b2World({ 0.0f, -9.8f });
+        m_PhysicsAccumulator = 0.0f;
+        m_PhysicsAlpha = 0.0f;
+        m_PhysicsSyncBodies.clear();
+        m_PhysicsSyncSlots.clear();
+        m_PhysicsThread = createScope<PhysicsThread>();
+
+        if (auto project = Project::getActive()) {
+            setPhysicsTickRate(project->getConfig().physicsTickRate);
+            setPhysicsMaxSubSteps(project->getConfig().physicsMaxSubSteps);
+        }
+
+        // Created by the physics updates within their budget, static bodies first so what falls has something to land on
+        m_PhysicsPendingBodies.clear();
+        m_PhysicsPendingCursor = 0;
 
         auto view = m_Registry.view<Rigidbody2DComponent>();
         for (auto e : view) {
-            Entity entity = { e, this };
-            auto& transform = entity.getComponent<TransformComponent>();
-            auto& rb2d = entity.getComponent<Rigidbody2DComponent>();
+            if (view.get<Rigidbody2DComponent>(e).type == Rigidbody2DComponent::BodyType::Static) {
+                m_PhysicsPendingBodies.push_back(e);
+            }
+        }
+        for (auto e : view) {
+            if (view.get<Rigidbody2DComponent>(e).type != Rigidbody2DComponent::BodyType::Static) {
+                m_PhysicsPendingBodies.push_back(e);
+            }
+        }
+    }
+
+    // Bodies are created at the next physics update rather than in the construct hook,
+    // components are usually filled in after they were added
+    void Scene::createPhysics2DBody(entt::entity e)
+    {
+        auto& transform = m_Registry.get<TransformComponent>(e);
+        auto& rb2d = m_Registry.get<Rigidbody2DComponent>(e);
+
+        auto* body = (b2Body*)rb2d.runtimeBody;
+        if (!body) {
+            // Bodies live in world space, a parented entity only stores its pose relative to the parent
+            glm::vec3 translation = transform.getTranslation(), rotation = transform.getRotation(), scale;
+            glm::mat4 parentTransform;
+            if (computeParentWorldTransform(e, parentTransform)) {
+                math::decomposeTransform(parentTransform * transform.getTransform(), translation, rotation, scale);
+            }
 
             b2BodyDef bodyDef;
             bodyDef.type = utils::rigidbody2DTypeToBox2DBody(rb2d.type);
-            bodyDef.position.Set(transform.translation.x, transform.translation.y);
-            bodyDef.angle = transform.rotation.z;
+            bodyDef.position.Set(translation.x, translation.y);
+            bodyDef.angle = rotation.z;
+            bodyDef.userData.pointer = (uintptr_t)e;
 
-            b2Body* body = m_PhysicsWorld->CreateBody(&bodyDef);
+            body = m_PhysicsWorld->CreateBody(&bodyDef);
             body->SetFixedRotation(rb2d.fixedRotation);
             rb2d.runtimeBody = body;
+        }
 
-            if (entity.hasComponent<BoxCollider2DComponent>()) {
-                auto& bc2d = entity.getComponent<BoxCollider2DComponent>();
+        if (auto* bc2d = m_Registry.try_get<BoxCollider2DComponent>(e); bc2d && !bc2d->runtimeFixture) {
+            b2PolygonShape boxShape;
+            boxShape.SetAsBox(bc2d->size.x * transform.getScale().x, bc2d->size.y * transform.getScale().y, b2Vec2(bc2d->offset.x, bc2d->offset.y), 0.0f);
+
+            b2FixtureDef fixtureDef;
+            fixtureDef.shape = &boxShape;
+            fixtureDef.density = bc2d->density;
+            fixtureDef.friction = bc2d->friction;
+            fixtureDef.restitution = bc2d->restitution;
+            fixtureDef.restitutionThreshold = bc2d->restitutionThreshold;
+            bc2d->runtimeFixture = body->CreateFixture(&fixtureDef);
+        }
 
-                b2PolygonShape boxShape;
-                boxShape.SetAsBox(bc2d.size.x * transform.scale.x, bc2d.size.y * transform.scale.y, b2Vec2(bc2d.offset.x, bc2d.offset.y), 0.0f);
+        if (auto* cc2d = m_Registry.try_get<CircleCollider2DComponent>(e); cc2d && !cc2d->runtimeFixture) {
+            b2CircleShape circleShape;
+            circleShape.m_p.Set(cc2d->offset.x, cc2d->offset.y);
+            circleShape.m_radius = transform.getScale().x * cc2d->radius;
+
+            b2FixtureDef fixtureDef;
+            fixtureDef.shape = &circleShape;
+            fixtureDef.density = cc2d->density;
+            fixtureDef.friction = cc2d->friction;
+            fixtureDef.restitution = cc2d->restitution;
+            fixtureDef.restitutionThreshold = cc2d->restitutionThreshold;
+            cc2d->runtimeFixture = body->CreateFixture(&fixtureDef);
+        }
+    }
 
-                b2FixtureDef fixtureDef;
-                fixtureDef.shape = &boxShape;
-                fixtureDef.density = bc2d.density;
-                fixtureDef.friction = bc2d.friction;
-                fixtureDef.restitution = bc2d.restitution;
-                fixtureDef.restitutionThreshold = bc2d.restitutionThreshold;
-                body->CreateFixture(&fixtureDef);
+    void Scene::createPendingPhysics2DBodies()
+    {
+        OAK_PROFILE_FUNCTION();
+
+        // Entries past the budget wait for the next frame, until then their entities are not simulated
+        const auto end = std::min(m_PhysicsPendingCursor + m_PhysicsBodiesPerFrame, m_PhysicsPendingBodies.size());
+        for (; m_PhysicsPendingCursor < end; m_PhysicsPendingCursor++) {
+            const auto e = m_PhysicsPendingBodies[m_PhysicsPendingCursor];
+            if (m_Registry.valid(e) && m_Registry.has<Rigidbody2DComponent>(e)) {
+                createPhysics2DBody(e);
             }
+        }
 
-            if (entity.hasComponent<CircleCollider2DComponent>()) {
-                auto& cc2d = entity.getComponent<CircleCollider2DComponent>();
+        if (m_PhysicsPendingCursor == m_PhysicsPendingBodies.size()) {
+            m_PhysicsPendingBodies.clear();
+            m_PhysicsPendingCursor = 0;
+        }
+    }
 
-                b2CircleShape circleShape;
-                circleShape.m_p.Set(cc2d.offset.x, cc2d.offset.y);
-                circleShape.m_radius = transform.scale.x * cc2d.radius;
+    b2Body* Scene::getPhysics2DBody(entt::entity e)
+    {
+        auto& rb2d = m_Registry.get<Rigidbody2DComponent>(e);
+        if (!rb2d.runtimeBody && m_PhysicsWorld) {
+            // Its pending entry finds the body in place and only adds colliders that are still missing
+            m_PhysicsThread->wait();
+            createPhysics2DBody(e);
+        }
 
-                b2FixtureDef fixtureDef;
-                fixtureDef.shape = &circleShape;
-                fixtureDef.density = cc2d.density;
-                fixtureDef.friction = cc2d.friction;
-                fixtureDef.restitution = cc2d.restitution;
-                fixtureDef.restitutionThreshold = cc2d.restitutionThreshold;
-                body->CreateFixture(&fixtureDef);
-            }
+        return (b2Body*)rb2d.runtimeBody;
+    }
+
+    void Scene::onRigidbody2DConstruct(entt::registry& registry, entt::entity e)
+    {
+        // A copied component still points at the body of the entity it was copied from
+        registry.get<Rigidbody2DComponent>(e).runtimeBody = nullptr;
+
+        if (m_PhysicsWorld) {
+            m_PhysicsPendingBodies.push_back(e);
+        }
+    }
+
+    void Scene::onRigidbody2DDestroy(entt::registry& registry, entt::entity e)
+    {
+        auto& rb2d = registry.get<Rigidbody2DComponent>(e);
+        if (!m_PhysicsWorld || !rb2d.runtimeBody) {
+            return;
+        }
+
+        m_PhysicsThread->wait();
+        removePhysics2DSyncBody(e);
+
+        // Destroying the body takes its fixtures with it
+        if (auto* bc2d = registry.try_get<BoxCollider2DComponent>(e)) {
+            bc2d->runtimeFixture = nullptr;
+        }
+        if (auto* cc2d = registry.try_get<CircleCollider2DComponent>(e)) {
+            cc2d->runtimeFixture = nullptr;
+        }
+
+        m_PhysicsWorld->DestroyBody((b2Body*)rb2d.runtimeBody);
+        rb2d.runtimeBody = nullptr;
+    }
+
+    template<typename Collider>
+    void Scene::onCollider2DConstruct(entt::registry& registry, entt::entity e)
+    {
+        registry.get<Collider>(e).runtimeFixture = nullptr;
+
+        if (m_PhysicsWorld) {
+            m_PhysicsPendingBodies.push_back(e);
         }
     }
 
+    template<typename Collider>
+    void Scene::onCollider2DDestroy(entt::registry& registry, entt::entity e)
+    {
+        auto& collider = registry.get<Collider>(e);
+        if (!m_PhysicsWorld || !collider.runtimeFixture) {
+            return;
+        }
+
+        m_PhysicsThread->wait();
+
+        auto* fixture = (b2Fixture*)collider.runtimeFixture;
+        fixture->GetBody()->DestroyFixture(fixture);
+        collider.runtimeFixture = nullptr;
+    }
+
     void Scene::onPhysics2DStop()
     {
+        // Joins the thread once the step in flight is done
+        m_PhysicsThread.reset();
+
         delete m_PhysicsWorld;
         m_PhysicsWorld = nullptr;
+        m_PhysicsPendingBodies.clear();
+        m_PhysicsPendingCursor = 0;
+
+        m_Registry.view<Rigidbody2DComponent>().each([](auto& rb2d) { rb2d.runtimeBody = nullptr; });
+        m_Registry.view<BoxCollider2DComponent>().each([](auto& bc2d) { bc2d.runtimeFixture = nullptr; });
+        m_Registry.view<CircleCollider2DComponent>().each([](auto& cc2d) { cc2d.runtimeFixture = nullptr; });
+    }
+
+    void Scene::stepPhysics2D(Timestep ts)
+    {
+        OAK_PROFILE_FUNCTION();
+
+        createPendingPhysics2DBodies();
+
+        m_PhysicsAccumulator += ts;
+        const auto steps = std::min((uint32_t)(m_PhysicsAccumulator / m_PhysicsTimestep), m_PhysicsMaxSubSteps);
+        m_PhysicsAccumulator -= (float)steps * m_PhysicsTimestep;
+
+        // A frame spike would otherwise make every following frame step more, drop the time we could not simulate
+        if (m_PhysicsAccumulator >= m_PhysicsTimestep) {
+            m_PhysicsAccumulator = std::fmod(m_PhysicsAccumulator, m_PhysicsTimestep);
+        }
+
+        // How far we are into the next step, used when the results are published
+        m_PhysicsAlpha = m_PhysicsAccumulator / m_PhysicsTimestep;
+
+        if (steps == 0) {
+            return;
+        }
+
+        // Only Box2D and the sync list are touched from here on, the registry stays with the main thread
+        m_PhysicsThread->submit([this, steps]() {
+            OAK_PROFILE_SCOPE("Scene::stepPhysics2D worker");
+
+            const int32_t velocityIterations = 6;
+            const int32_t positionIterations = 2;
+
+            for (auto& syncBody : m_PhysicsSyncBodies) {
+                m_PhysicsSyncSlots[entityIndex(syncBody.entity)] = noSyncSlot;
+            }
+            m_PhysicsSyncBodies.clear();
+
+            for (uint32_t step = 0; step < steps; step++) {
+                // Static and sleeping bodies cannot move during the step, so they never need copying back.
+                // A body woken by a contact in the last step is picked up next frame
+                for (auto* body = m_PhysicsWorld->GetBodyList(); body; body = body->GetNext()) {
+                    if (!body->IsAwake() || body->GetType() == b2_staticBody) {
+                        continue;
+                    }
+
+                    const auto e = (entt::entity)body->GetUserData().pointer;
+                    const auto index = entityIndex(e);
+                    if (index >= m_PhysicsSyncSlots.size()) {
+                        m_PhysicsSyncSlots.resize(index + 1, noSyncSlot);
+                    }
+
+                    auto& slot = m_PhysicsSyncSlots[index];
+                    if (slot == noSyncSlot) {
+                        slot = (uint32_t)m_PhysicsSyncBodies.size();
+                        m_PhysicsSyncBodies.push_back({ e, body });
+                    }
+
+                    auto& syncBody = m_PhysicsSyncBodies[slot];
+                    syncBody.previousPosition = { body->GetPosition().x, body->GetPosition().y };
+                    syncBody.previousAngle = body->GetAngle();
+                }
+
+                m_PhysicsWorld->Step(m_PhysicsTimestep, velocityIterations, positionIterations);
+            }
+        });
+    }
+
+    void Scene::syncPhysics2D()
+    {
+        OAK_PROFILE_FUNCTION();
+
+        m_PhysicsThread->wait();
+
+        // Roots first, so a parented body is placed relative to where its parent body ends up this frame
+        m_PhysicsParentedSlots.clear();
+        for (uint32_t slot = 0; slot < m_PhysicsSyncBodies.size(); slot++) {
+            const auto* relationship = m_Registry.try_get<RelationshipComponent>(m_PhysicsSyncBodies[slot].entity);
+            if (relationship && relationship->parent != 0) {
+                m_PhysicsParentedSlots.push_back(slot);
+                continue;
+            }
+
+            syncPhysics2DBody(slot, false);
+        }
+        for (auto slot : m_PhysicsParentedSlots) {
+            syncPhysics2DBody(slot, true);
+        }
+    }
+
+    void Scene::syncPhysics2DBody(uint32_t slot, bool parented)
+    {
+        auto& syncBody = m_PhysicsSyncBodies[slot];
+        auto& transform = m_Registry.get<TransformComponent>(syncBody.entity);
+
+        const auto& position = syncBody.body->GetPosition();
+        const auto angle = syncBody.body->GetAngle();
+
+        // Fell asleep, it rests where the last step left it
+        if (!syncBody.body->IsAwake()) {
+            syncBody.previousPosition = { position.x, position.y };
+            syncBody.previousAngle = angle;
+        }
+
+        // Blended between the last two steps by how far we are into the next one
+        const auto interpolatedPosition = glm::mix(syncBody.previousPosition, glm::vec2(position.x, position.y), m_PhysicsAlpha);
+        const auto interpolatedAngle = glm::mix(syncBody.previousAngle, angle, m_PhysicsAlpha);
+
+        if (!parented) {
+            const auto& rotation = transform.getRotation();
+            transform.setTranslation({ interpolatedPosition.x, interpolatedPosition.y, transform.getTranslation().z });
+            transform.setRotation({ rotation.x, rotation.y, interpolatedAngle });
+            return;
+        }
+
+        // The body pose is in world space, swap it into the world transform and bring that back under the parent
+        glm::mat4 parentTransform;
+        computeParentWorldTransform(syncBody.entity, parentTransform);
+
+        glm::vec3 translation, rotation, scale;
+        if (!math::decomposeTransform(parentTransform * transform.getTransform(), translation, rotation, scale)) {
+            return;
+        }
+        translation = { interpolatedPosition.x, interpolatedPosition.y, translation.z };
+        rotation.z = interpolatedAngle;
+
+        const auto localTransform = glm::inverse(parentTransform) * composeTransform(translation, rotation, scale);
+        if (math::decomposeTransform(localTransform, translation, rotation, scale)) {
+            transform.setTranslation(translation);
+            transform.setRotation(rotation);
+            transform.setScale(scale);
+        }
+    }
+
+    void Scene::removePhysics2DSyncBody(entt::entity e)
+    {
+        const auto index = entityIndex(e);
+        if (index >= m_PhysicsSyncSlots.size() || m_PhysicsSyncSlots[index] == noSyncSlot) {
+            return;
+        }
+
+        const auto slot = m_PhysicsSyncSlots[index];
+        m_PhysicsSyncSlots[index] = noSyncSlot;
+
+        if (slot != m_PhysicsSyncBodies.size() - 1) {
+            m_PhysicsSyncBodies[slot] = m_PhysicsSyncBodies.back();
+            m_PhysicsSyncSlots[entityIndex(m_PhysicsSyncBodies[slot].entity)] = slot;
+        }
+        m_PhysicsSyncBodies.pop_back();
+    }
+
+    // Keeps the closest fixture, clipping the ray to every hit so far
+    class ClosestRaycastCallback : public b2RayCastCallback
+    {
+    public:
+        float ReportFixture(b2Fixture* fixture, const b2Vec2& point, const b2Vec2& normal, float fraction) override
+        {
+            body = fixture->GetBody();
+            hitPoint = point;
+            hitNormal = normal;
+            hitFraction = fraction;
+            return fraction;
+        }
+
+        b2Body* body = nullptr;
+        b2Vec2 hitPoint;
+        b2Vec2 hitNormal;
+        float hitFraction = 1.0f;
+    };
+
+    // Collects the bodies of fixtures that pass `test`, once per body
+    template<typename Test>
+    class BodyQueryCallback : public b2QueryCallback
+    {
+    public:
+        BodyQueryCallback(std::vector<b2Body*>& bodies, Test test) : m_Bodies(bodies), m_Test(test) {}
+
+        bool ReportFixture(b2Fixture* fixture) override
+        {
+            auto* body = fixture->GetBody();
+            if (m_Test(fixture) && std::find(m_Bodies.begin(), m_Bodies.end(), body) == m_Bodies.end()) {
+                m_Bodies.push_back(body);
+            }
+            return true;
+        }
+
+    private:
+        std::vector<b2Body*>& m_Bodies;
+        Test m_Test;
+    };
+
+    void Scene::raycast2D(std::span<const glm::vec2> starts, std::span<const glm::vec2> ends, std::span<RaycastHit2D> outHits)
+    {
+        OAK_PROFILE_FUNCTION();
+        OAK_CORE_ASSERT(ends.size() >= starts.size() && outHits.size() >= starts.size());
+
+        if (!m_PhysicsWorld) {
+            std::fill_n(outHits.begin(), starts.size(), RaycastHit2D{});
+            return;
+        }
+
+        m_PhysicsThread->wait();
+
+        for (size_t i = 0; i < starts.size(); i++) {
+            auto& hit = outHits[i];
+            hit = {};
+
+            const b2Vec2 start(starts[i].x, starts[i].y);
+            const b2Vec2 end(ends[i].x, ends[i].y);
+            if ((end - start).LengthSquared() <= 0.0f) {
+                continue;
+            }
+
+            ClosestRaycastCallback callback;
+            m_PhysicsWorld->RayCast(&callback, start, end);
+            if (!callback.body) {
+                continue;
+            }
+
+            const auto e = (entt::entity)callback.body->GetUserData().pointer;
+            hit.entityID = m_Registry.get<IDComponent>(e).id;
+            hit.point = { callback.hitPoint.x, callback.hitPoint.y };
+            hit.normal = { callback.hitNormal.x, callback.hitNormal.y };
+            hit.fraction = callback.hitFraction;
+        }
+    }
+
+    // Shared by the overlap queries, `query(i, bodies)` fills in the bodies found by query i
+    template<typename Query>
+    static size_t collectQueryResults(entt::registry& registry, size_t queryCount, Query&& query, std::span<UUID> outEntityIDs, std::span<uint32_t> outCounts)
+    {
+        OAK_CORE_ASSERT(outCounts.size() >= queryCount);
+
+        std::vector<b2Body*> bodies;
+        size_t written = 0;
+        size_t total = 0;
+        for (size_t i = 0; i < queryCount; i++) {
+            bodies.clear();
+            query(i, bodies);
+
+            uint32_t count = 0;
+            for (auto* body : bodies) {
+                if (written < outEntityIDs.size()) {
+                    const auto e = (entt::entity)body->GetUserData().pointer;
+                    outEntityIDs[written++] = registry.get<IDComponent>(e).id;
+                    count++;
+                }
+            }
+
+            outCounts[i] = count;
+            total += bodies.size();
+        }
+
+        return total;
+    }
+
+    size_t Scene::overlapBox2D(std::span<const glm::vec2> mins, std::span<const glm::vec2> maxs, std::span<UUID> outEntityIDs, std::span<uint32_t> outCounts)
+    {
+        OAK_PROFILE_FUNCTION();
+        OAK_CORE_ASSERT(maxs.size() >= mins.size() && outCounts.size() >= mins.size());
+
+        if (!m_PhysicsWorld) {
+            std::fill_n(outCounts.begin(), mins.size(), 0u);
+            return 0;
+        }
+
+        m_PhysicsThread->wait();
+
+        return collectQueryResults(m_Registry, mins.size(), [&](size_t i, std::vector<b2Body*>& bodies) {
+            b2AABB box;
+            box.lowerBound.Set(mins[i].x, mins[i].y);
+            box.upperBound.Set(maxs[i].x, maxs[i].y);
+
+            // The broadphase reports fattened bounds, test the fixture's own
+            auto test = [&box](b2Fixture* fixture) {
+                for (int32 child = 0; child < fixture->GetShape()->GetChildCount(); child++) {
+                    if (b2TestOverlap(box, fixture->GetAABB(child))) {
+                        return true;
+                    }
+                }
+                return false;
+            };
+
+            BodyQueryCallback callback(bodies, test);
+            m_PhysicsWorld->QueryAABB(&callback, box);
+        }, outEntityIDs, outCounts);
+    }
+
+    size_t Scene::queryPoint2D(std::span<const glm::vec2> points, std::span<UUID> outEntityIDs, std::span<uint32_t> outCounts)
+    {
+        OAK_PROFILE_FUNCTION();
+        OAK_CORE_ASSERT(outCounts.size() >= points.size());
+
+        if (!m_PhysicsWorld) {
+            std::fill_n(outCounts.begin(), points.size(), 0u);
+            return 0;
+        }
+
+        m_PhysicsThread->wait();
+
+        return collectQueryResults(m_Registry, points.size(), [&](size_t i, std::vector<b2Body*>& bodies) {
+            const b2Vec2 point(points[i].x, points[i].y);
+
+            b2AABB box;
+            box.lowerBound = point;
+            box.upperBound = point;
+
+            auto test = [&point](b2Fixture* fixture) { return fixture->TestPoint(point); };
+
+            BodyQueryCallback callback(bodies, test);
+            m_PhysicsWorld->QueryAABB(&callback, box);
+        }, outEntityIDs, outCounts);
     }
 
     void Scene::renderScene(EditorCamera& camera)
     {
+        updateTransformHierarchy();
+        updateSpatialIndex();
+
         Renderer2D::beginScene(camera);
 
+        submitRenderables(camera.getViewProjection());
+
+        Renderer2D::endScene();
+    }
+
+    static Renderer2D::TextParams getTextParams(const TextComponent& text)
+    {
+        return { text.color, text.kerning, text.lineSpacing };
+    }
+
+    // Local XY bounds of everything the entity draws, false when it draws nothing
+    static bool computeRenderableBounds(entt::registry& registry, entt::entity entity, glm::vec2& min, glm::vec2& max)
+    {
+        min = glm::vec2(std::numeric_limits<float>::max());
+        max = glm::vec2(std::numeric_limits<float>::lowest());
+
+        // Sprites and circles are drawn on the unit quad
+        if (registry.has<SpriteRendererComponent>(entity) || registry.has<CircleRendererComponent>(entity)) {
+            min = glm::vec2(-0.5f);
+            max = glm::vec2(0.5f);
+        }
+
+        if (const auto* text = registry.try_get<TextComponent>(entity)) {
+            glm::vec2 textMin, textMax;
+            if (Renderer2D::computeStringBounds(text->textString, text->fontAsset, getTextParams(*text), textMin, textMax)) {
+                min = glm::min(min, textMin);
+                max = glm::max(max, textMax);
+            }
+        }
+
+        return min.x <= max.x;
+    }
+
+    // Whether a point in the entity's local XY plane lands on something it draws
+    static bool isRenderableHit(entt::registry& registry, entt::entity entity, const glm::vec2& local)
+    {
+        if (registry.has<SpriteRendererComponent>(entity) && glm::abs(local.x) <= 0.5f && glm::abs(local.y) <= 0.5f) {
+            return true;
+        }
+
+        if (const auto* circle = registry.try_get<CircleRendererComponent>(entity)) {
+            // The circle shader fills the ring between 1 - thickness and 1 of the doubled local radius
+            const auto radius = 2.0f * glm::length(local);
+            if (radius <= 1.0f && radius >= 1.0f - circle->thickness) {
+                return true;
+            }
+        }
+
+        if (const auto* text = registry.try_get<TextComponent>(entity)) {
+            glm::vec2 min, max;
+            if (Renderer2D::computeStringBounds(text->textString, text->fontAsset, getTextParams(*text), min, max)
+                && local.x >= min.x && local.y >= min.y && local.x <= max.x && local.y <= max.y) {
+                return true;
+            }
+        }
+
+        return false;
+    }
+
+    // World bounds of a local XY rectangle placed by a world matrix
+    static void computeRectBounds(const glm::mat4& transform, const glm::vec2& localMin, const glm::vec2& localMax, glm::vec3& min, glm::vec3& max)
+    {
+        const auto center = glm::vec3(transform * glm::vec4(0.5f * (localMin + localMax), 0.0f, 1.0f));
+        const auto halfSize = 0.5f * (localMax - localMin);
+        const auto halfExtents = glm::abs(glm::vec3(transform[0])) * halfSize.x + glm::abs(glm::vec3(transform[1])) * halfSize.y;
+
+        min = center - halfExtents;
+        max = center + halfExtents;
+    }
+
+    // XY bounds of everything a view-projection can see
+    static void computeViewBounds(const glm::mat4& viewProjection, glm::vec2& min, glm::vec2& max)
+    {
+        const auto inverse = glm::inverse(viewProjection);
+
+        min = glm::vec2(std::numeric_limits<float>::max());
+        max = glm::vec2(std::numeric_limits<float>::lowest());
+        for (int i = 0; i < 8; i++) {
+            glm::vec4 corner = inverse * glm::vec4(i & 1 ? 1.0f : -1.0f, i & 2 ? 1.0f : -1.0f, i & 4 ? 1.0f : -1.0f, 1.0f);
+            const glm::vec2 point = glm::vec2(corner) / corner.w;
+
+            min = glm::min(min, point);
+            max = glm::max(max, point);
+        }
+    }
+
+    void Scene::updateSpatialIndex()
+    {
+        OAK_PROFILE_FUNCTION();
+
+        // Only entities logged since the last update are measured again, static scenes cost nothing here
+        for (auto handle : m_ChangedEntities) {
+            const auto entity = static_cast<entt::entity>(handle);
+            if (!m_Registry.valid(entity)) {
+                continue;
+            }
+
+            auto* transform = m_Registry.try_get<TransformComponent>(entity);
+            if (!transform) {
+                continue;
+            }
+            transform->clearChanged();
+
+            // Only what gets drawn is indexed, with the bounds it is drawn with
+            glm::vec2 localMin, localMax;
+            if (!computeRenderableBounds(m_Registry, entity, localMin, localMax)) {
+                m_SpatialIndex->remove(entity);
+                continue;
+            }
+
+            glm::vec3 min, max;
+            computeRectBounds(transform->getWorldTransform(), localMin, localMax, min, max);
+            m_SpatialIndex->update(entity, glm::vec2(min), glm::vec2(max));
+
+            m_IndexedMinZ = std::min(m_IndexedMinZ, min.z);
+            m_IndexedMaxZ = std::max(m_IndexedMaxZ, max.z);
+        }
+
+        m_ChangedEntities.clear();
+    }
+
+    void Scene::onTransformConstruct(entt::registry& registry, entt::entity e)
+    {
+        registry.get<TransformComponent>(e).attachChangeLog(&m_ChangedEntities, static_cast<uint32_t>(e));
+    }
+
+    void Scene::onRenderableChange(entt::registry& registry, entt::entity e)
+    {
+        if (auto* transform = registry.try_get<TransformComponent>(e)) {
+            transform->markChanged();
+        }
+    }
+
+    void Scene::onRenderableDestroy(entt::registry& registry, entt::entity e)
+    {
+        if (m_SpatialIndex) {
+            m_SpatialIndex->remove(e);
+            onRenderableChange(registry, e);
+        }
+    }
+
+    std::vector<Entity> Scene::queryRegion(const glm::vec2& min, const glm::vec2& max)
+    {
+        OAK_PROFILE_FUNCTION();
+
+        std::vector<Entity> result;
+        m_SpatialIndex->queryRegion(min, max, [&](entt::entity entity) {
+            result.emplace_back(entity, this);
+            return true;
+        });
+
+        return result;
+    }
+
+    std::vector<Entity> Scene::queryPoint(const glm::vec2& point)
+    {
+        return queryRegion(point, point);
+    }
+
+    Entity Scene::pickEntity(const glm::vec3& rayOrigin, const glm::vec3& rayDirection)
+    {
+        OAK_PROFILE_FUNCTION();
+
+        // The index is 2D, so candidates come from the stretch of the ray inside the depth range of everything indexed
+        if (m_SpatialIndex->getCount() == 0 || glm::abs(rayDirection.z) < std::numeric_limits<float>::epsilon()) {
+            return {};
+        }
+
+        auto nearDistance = (m_IndexedMinZ - rayOrigin.z) / rayDirection.z;
+        auto farDistance = (m_IndexedMaxZ - rayOrigin.z) / rayDirection.z;
+        if (nearDistance > farDistance) {
+            std::swap(nearDistance, farDistance);
+        }
+        if (farDistance < 0.0f) {
+            return {};
+        }
+        nearDistance = std::max(nearDistance, 0.0f);
+
+        const auto nearPoint = glm::vec2(rayOrigin + nearDistance * rayDirection);
+        const auto farPoint = glm::vec2(rayOrigin + farDistance * rayDirection);
+
+        Entity closest = {};
+        auto closestDistance = std::numeric_limits<float>::max();
+
+        m_SpatialIndex->queryRegion(glm::min(nearPoint, farPoint), glm::max(nearPoint, farPoint), [&](entt::entity entity) {
+            const auto& transform = m_Registry.get<TransformComponent>(entity).getWorldTransform();
+
+            // Intersect the ray with the entity's own plane and test the hit against what it draws in local space
+            const auto normal = glm::cross(glm::vec3(transform[0]), glm::vec3(transform[1]));
+            const auto denominator = glm::dot(normal, rayDirection);
+            if (glm::abs(denominator) < std::numeric_limits<float>::epsilon()) {
+                return true;
+            }
+
+            const auto distance = glm::dot(normal, glm::vec3(transform[3]) - rayOrigin) / denominator;
+            if (distance < 0.0f || distance >= closestDistance) {
+                return true;
+            }
+
+            const auto local = glm::inverse(transform) * glm::vec4(rayOrigin + distance * rayDirection, 1.0f);
+            if (isRenderableHit(m_Registry, entity, glm::vec2(local))) {
+                closest = { entity, this };
+                closestDistance = distance;
+            }
+
+            return true;
+        });
+
+        return closest;
+    }
+
+    void Scene::submitRenderables(const glm::mat4& viewProjection)
+    {
+        OAK_PROFILE_FUNCTION();
+
+        glm::vec2 viewMin, viewMax;
+        computeViewBounds(viewProjection, viewMin, viewMax);
+
+        m_VisibleEntities.clear();
+        m_SpatialIndex->queryRegion(viewMin, viewMax, [&](entt::entity entity) {
+            m_VisibleEntities.push_back(entity);
+            return true;
+        });
+
+        // When most of the scene is in view, walking the packed storage beats the scattered lookups
+        const auto useIndex = m_VisibleEntities.size() * 2 < m_SpatialIndex->getCount();
+
         // Draw sprites
         {
-            auto group = m_Registry.group<TransformComponent>(entt::get<SpriteRendererComponent>);
-            for (auto entity : group) {
-                auto [transform, sprite] = group.get<TransformComponent, SpriteRendererComponent>(entity);
+            // The group owns both components, so they are packed in matching order and can be drawn in one batch
+            auto group = m_Registry.group<TransformComponent, SpriteRendererComponent>();
+            if (useIndex) {
+                for (auto entity : m_VisibleEntities) {
+                    if (!group.contains(entity)) {
+                        continue;
+                    }
 
-                Renderer2D::drawSprite(transform.getTransform(), sprite, (int)entity);
+                    auto [transform, sprite] = group.get<TransformComponent, SpriteRendererComponent>(entity);
+                    Renderer2D::drawSprite(transform.getWorldTransform(), sprite, (int)entity);
+                }
+            }
+            else {
+                Renderer2D::drawQuads({ group.raw<TransformComponent>(), group.size() }, { group.raw<SpriteRendererComponent>(), group.size() }, { group.data(), group.size() });
             }
         }
 
         // Draw circles
         {
             auto view = m_Registry.view<TransformComponent, CircleRendererComponent>();
-            for (auto entity : view) {
+            auto drawCircle = [&](entt::entity entity) {
                 auto [transform, circle] = view.get<TransformComponent, CircleRendererComponent>(entity);
 
-                Renderer2D::drawCircle(transform.getTransform(), circle.color, circle.thickness, circle.fade, (int)entity);
+                Renderer2D::drawCircle(transform.getWorldTransform(), circle.color, circle.thickness, circle.fade, (int)entity);
+            };
+
+            if (useIndex) {
+                for (auto entity : m_VisibleEntities) {
+                    if (view.contains(entity)) {
+                        drawCircle(entity);
+                    }
+                }
+            }
+            else {
+                for (auto entity : view) {
+                    drawCircle(entity);
+                }
             }
         }
 
-        // Draw text
+        // Draw text, strings that are partly in view are culled per glyph by Renderer2D
         {
             auto view = m_Registry.view<TransformComponent, TextComponent>();
-            for (auto entity : view) {
+            auto drawText = [&](entt::entity entity) {
                 auto [transform, text] = view.get<TransformComponent, TextComponent>(entity);
 
-                Renderer2D::drawString(text.textString, transform.getTransform(), text, (int)entity);
+                Renderer2D::drawString(text.textString, transform.getWorldTransform(), text, (int)entity);
+            };
+
+            if (useIndex) {
+                for (auto entity : m_VisibleEntities) {
+                    if (view.contains(entity)) {
+                        drawText(entity);
+                    }
+                }
+            }
+            else {
+                for (auto entity : view) {
+                    drawText(entity);
+                }
             }
         }
-
-        Renderer2D::endScene();
     }
   
   template<typename T>
@@ -468,6 +1382,12 @@ namespace oak {
     {
     }
 
+    template<>
+    void Scene::onComponentAdded<RelationshipComponent>(Entity entity, RelationshipComponent& component)
+    {
+        m_TransformHierarchyDirty = true;
+    }
+
     template<>
     void Scene::onComponentAdded<CameraComponent>(Entity entity, CameraComponent& component)
     {
@@ -6,11 +6,24 @@
 
 #include "entt.hpp"
 
+#include <span>
+
 class b2World;
+class b2Body;
 class SceneHierarchyPanel;
 
 namespace oak {
     class Entity;
+    class SpatialIndex;
+    class PhysicsThread;
+
+    struct RaycastHit2D
+    {
+        UUID entityID = 0; // 0 when the ray hit nothing
+        glm::vec2 point = { 0.0f, 0.0f };
+        glm::vec2 normal = { 0.0f, 0.0f };
+        float fraction = 1.0f; // Along the ray, 0 at its start and 1 at its end
+    };
 
     class Scene
     {
@@ -37,8 +50,32 @@ namespace oak {
 
         Entity duplicateEntity(Entity entity);
 
+        // Keeps the world transform of `entity`, its local transform becomes relative to `parent`
+        void parentEntity(Entity entity, Entity parent);
+        void unparentEntity(Entity entity);
+        bool isDescendantOf(Entity entity, Entity ancestor);
+
+        // Spatial queries in the XY plane over sprites, circles and text, answered from the bounds of the last update
+        std::vector<Entity> queryRegion(const glm::vec2& min, const glm::vec2& max);
+        std::vector<Entity> queryPoint(const glm::vec2& point);
+        // Closest entity whose drawn sprite, circle ring or text is hit by the ray
+        Entity pickEntity(const glm::vec3& rayOrigin, const glm::vec3& rayDirection);
+
+        // Physics queries against the colliders of the last step, batched so one call answers many queries.
+        // The first span sets the number of queries, the others may be longer.
+        // Closest hit of each segment from starts[i] to ends[i]
+        void raycast2D(std::span<const glm::vec2> starts, std::span<const glm::vec2> ends, std::span<RaycastHit2D> outHits);
+        // The entities found by each query are appended to outEntityIDs, outCounts[i] is how many query i added.
+        // Entities that do not fit are counted in the return value but not written, so callers can grow the buffer and retry
+        size_t overlapBox2D(std::span<const glm::vec2> mins, std::span<const glm::vec2> maxs, std::span<UUID> outEntityIDs, std::span<uint32_t> outCounts);
+        size_t queryPoint2D(std::span<const glm::vec2> points, std::span<UUID> outEntityIDs, std::span<uint32_t> outCounts);
+
         Entity findEntityByName(std::string_view name);
         Entity getEntityByUUID(UUID uuid);
+        // Null entity when the handle is stale or was never created
+        Entity getEntityByHandle(entt::entity handle);
+        // Creates the body of `e` right away when it still waits for a frame's creation budget, main thread only
+        b2Body* getPhysics2DBody(entt::entity e);
 
         Entity getPrimaryCameraEntity();
 
@@ -47,6 +84,10 @@ namespace oak {
 
         void setPaused(bool paused) { m_IsPaused = paused; }
 
+        // Fixed physics step, taken from the active project when physics starts
+        void setPhysicsTickRate(uint32_t stepsPerSecond) { m_PhysicsTimestep = 1.0f / (float)std::max(stepsPerSecond, 1u); }
+        void setPhysicsMaxSubSteps(uint32_t maxSubSteps) { m_PhysicsMaxSubSteps = std::max(maxSubSteps, 1u); }
+
         void step(int frames = 1);
 
         template<typename... Components>
@@ -61,8 +102,43 @@ namespace oak {
 
         void onPhysics2DStart();
         void onPhysics2DStop();
+        // Creates the body of `e` if it has none, and fixtures for colliders that have none
+        void createPhysics2DBody(entt::entity e);
+        void createPendingPhysics2DBodies();
+        // Starts this frame's fixed steps on the physics thread
+        void stepPhysics2D(Timestep ts);
+        // Waits for the steps in flight and writes the interpolated body state to the transforms
+        void syncPhysics2D();
+        // Parented bodies are converted from the world pose Box2D keeps to the entity's local transform
+        void syncPhysics2DBody(uint32_t slot, bool parented);
+        void removePhysics2DSyncBody(entt::entity e);
+
+        // Registry hooks, bodies and fixtures follow their components while physics runs
+        void onRigidbody2DConstruct(entt::registry& registry, entt::entity e);
+        void onRigidbody2DDestroy(entt::registry& registry, entt::entity e);
+        template<typename Collider>
+        void onCollider2DConstruct(entt::registry& registry, entt::entity e);
+        template<typename Collider>
+        void onCollider2DDestroy(entt::registry& registry, entt::entity e);
+        // Transforms log themselves into m_ChangedEntities, renderables that change log their transform
+        void onTransformConstruct(entt::registry& registry, entt::entity e);
+        void onRenderableChange(entt::registry& registry, entt::entity e);
+        // An entity that stops drawing something leaves the index, the next update puts it back if it still draws
+        void onRenderableDestroy(entt::registry& registry, entt::entity e);
 
         void renderScene(oak::EditorCamera& camera);
+        void submitRenderables(const glm::mat4& viewProjection);
+
+        void linkEntity(Entity entity, Entity parent);
+        // Walks the parent chain, so it is current even before the hierarchy pass ran this frame
+        glm::mat4 computeWorldTransform(entt::entity e);
+        // World transform of the parent of `e`, false when `e` is a root
+        bool computeParentWorldTransform(entt::entity e, glm::mat4& outTransform);
+        Entity duplicateEntityTree(Entity entity, Entity parent);
+
+        void rebuildTransformHierarchy();
+        void updateTransformHierarchy();
+        void updateSpatialIndex();
 
         entt::registry m_Registry;
         uint32_t m_ViewportWidth = 0, m_ViewportHeight = 0;
@@ -71,9 +147,52 @@ namespace oak {
         int m_StepFrames = 0;
 
         b2World* m_PhysicsWorld = nullptr;
+        float m_PhysicsTimestep = 1.0f / 60.0f;
+        uint32_t m_PhysicsMaxSubSteps = 8;
+        float m_PhysicsAccumulator = 0.0f;
+        float m_PhysicsAlpha = 0.0f;
+        Scope<PhysicsThread> m_PhysicsThread;
+
+        // Bodies that were awake during the last steps, written by the physics thread while it steps
+        struct PhysicsSyncBody
+        {
+            entt::entity entity;
+            b2Body* body;
+            glm::vec2 previousPosition = { 0.0f, 0.0f }; // Body state before the last step, for interpolation
+            float previousAngle = 0.0f;
+        };
+        static constexpr uint32_t noSyncSlot = std::numeric_limits<uint32_t>::max();
+        std::vector<PhysicsSyncBody> m_PhysicsSyncBodies;
+        std::vector<uint32_t> m_PhysicsSyncSlots; // Entity index to its position in m_PhysicsSyncBodies
+        std::vector<entt::entity> m_PhysicsPendingBodies; // Bodies still to create, including the whole scene when physics starts
+        size_t m_PhysicsPendingCursor = 0; // First entry of m_PhysicsPendingBodies not handled yet
+        uint32_t m_PhysicsBodiesPerFrame = 512; // Creation budget, spreads the start of a large scene over a few frames
+        std::vector<uint32_t> m_PhysicsParentedSlots; // Scratch for syncPhysics2D, bodies synced after the roots
 
         std::unordered_map<UUID, entt::entity> m_EntityMap;
 
+        // Flattened hierarchy, depth-first so a parent always comes before its children.
+        // Only entities that have a parent or children get a node.
+        struct TransformNode
+        {
+            static constexpr uint32_t noParent = std::numeric_limits<uint32_t>::max();
+
+            entt::entity entity;
+            uint32_t parentIndex;
+            uint32_t version;
+        };
+        std::vector<TransformNode> m_TransformNodes;
+        std::vector<glm::mat4> m_WorldTransforms; // Parallel to m_TransformNodes
+        std::vector<uint8_t> m_TransformChanged;  // Parallel to m_TransformNodes
+        bool m_TransformHierarchyDirty = true;
+
+        Scope<SpatialIndex> m_SpatialIndex;
+        std::vector<uint32_t> m_ChangedEntities; // Transforms or renderables that changed since the last index update
+        // Depth range of everything indexed so far, bounds the stretch of a pick ray worth querying
+        float m_IndexedMinZ = std::numeric_limits<float>::max();
+        float m_IndexedMaxZ = std::numeric_limits<float>::lowest();
+        std::vector<entt::entity> m_VisibleEntities; // Scratch for view queries
+
         friend class Entity;
         friend class SceneSerializer;
         friend class ::SceneHierarchyPanel;
@@ -202,13 +202,29 @@ namespace oak {
             out << YAML::BeginMap; // TransformComponent
 
             auto& tc = entity.getComponent<TransformComponent>();
-            out << YAML::Key << "Translation" << YAML::Value << tc.translation;
-            out << YAML::Key << "Rotation" << YAML::Value << tc.rotation;
-            out << YAML::Key << "Scale" << YAML::Value << tc.scale;
+            out << YAML::Key << "Translation" << YAML::Value << tc.getTranslation();
+            out << YAML::Key << "Rotation" << YAML::Value << tc.getRotation();
+            out << YAML::Key << "Scale" << YAML::Value << tc.getScale();
 
             out << YAML::EndMap; // TransformComponent
         }
 
+        if (entity.hasComponent<RelationshipComponent>()) {
+            out << YAML::Key << "RelationshipComponent";
+            out << YAML::BeginMap; // RelationshipComponent
+
+            auto& rc = entity.getComponent<RelationshipComponent>();
+            out << YAML::Key << "Parent" << YAML::Value << (uint64_t)rc.parent;
+
+            out << YAML::Key << "Children" << YAML::Value << YAML::BeginSeq;
+            for (auto child : rc.children) {
+                out << (uint64_t)child;
+            }
+            out << YAML::EndSeq;
+
+            out << YAML::EndMap; // RelationshipComponent
+        }
+
         if (entity.hasComponent<CameraComponent>()) {
             out << YAML::Key << "CameraComponent";
             out << YAML::BeginMap; // CameraComponent
@@ -245,19 +261,19 @@ namespace oak {
             const auto& fields = entityClass->getFields();
             if (fields.size() > 0) {
                 out << YAML::Key << "ScriptFields" << YAML::Value;
-                auto& entityFields = ScriptEngine::getScriptFieldMap(entity);
+                auto* entityFields = ScriptEngine::findScriptFields(entity);
                 out << YAML::BeginSeq;
-                for (const auto& [name, field] : fields) {
-                    if (entityFields.find(name) == entityFields.end()) {
+                for (const auto& field : fields) {
+                    if (!entityFields || !entityFields[field.index].isSet()) {
                         continue;
                     }
 
                     out << YAML::BeginMap; // ScriptField
-                    out << YAML::Key << "Name" << YAML::Value << name;
+                    out << YAML::Key << "Name" << YAML::Value << field.name;
                     out << YAML::Key << "Type" << YAML::Value << utils::scriptFieldTypeToString(field.type);
 
                     out << YAML::Key << "Data" << YAML::Value;
-                    ScriptFieldInstance& scriptField = entityFields.at(name);
+                    ScriptFieldInstance& scriptField = entityFields[field.index];
 
                     switch (field.type) {
                         WRITE_SCRIPT_FIELD(Float,   float     );
@@ -434,9 +450,20 @@ namespace oak {
                 if (transformComponent) {
                     // Entities always have transforms
                     auto& tc = deserializedEntity.getComponent<TransformComponent>();
-                    tc.translation = transformComponent["Translation"].as<glm::vec3>();
-                    tc.rotation = transformComponent["Rotation"].as<glm::vec3>();
-                    tc.scale = transformComponent["Scale"].as<glm::vec3>();
+                    tc.setTranslation(transformComponent["Translation"].as<glm::vec3>());
+                    tc.setRotation(transformComponent["Rotation"].as<glm::vec3>());
+                    tc.setScale(transformComponent["Scale"].as<glm::vec3>());
+                }
+
+                auto relationshipComponent = entity["RelationshipComponent"];
+                if (relationshipComponent) {
+                    // Local transforms are stored, so the links can be restored without touching them
+                    auto& rc = deserializedEntity.addComponent<RelationshipComponent>();
+                    rc.parent = relationshipComponent["Parent"].as<uint64_t>();
+
+                    for (auto child : relationshipComponent["Children"]) {
+                        rc.children.emplace_back(child.as<uint64_t>());
+                    }
                 }
 
                 auto cameraComponent = entity["CameraComponent"];
@@ -467,24 +494,23 @@ namespace oak {
                     if (scriptFields) {
                         Ref<ScriptClass> entityClass = ScriptEngine::getEntityClass(sc.className);
                         if (entityClass) {
-                            const auto& fields = entityClass->getFields();
-                            auto& entityFields = ScriptEngine::getScriptFieldMap(deserializedEntity);
+                            auto* entityFields = ScriptEngine::getScriptFields(deserializedEntity);
 
                             for (auto scriptField : scriptFields) {
                                 std::string name = scriptField["Name"].as<std::string>();
                                 std::string typeString = scriptField["Type"].as<std::string>();
                                 ScriptFieldType type = utils::scriptFieldTypeFromString(typeString);
 
-                                ScriptFieldInstance& fieldInstance = entityFields[name];
+                                const auto* field = entityClass->findField(name);
 
                                 // TODO: turn this assert into OakEd log warning
-                                OAK_CORE_ASSERT(fields.find(name) != fields.end());
+                                OAK_CORE_ASSERT(field);
 
-                                if (fields.find(name) == fields.end()) {
+                                if (!field) {
                                     continue;
                                 }
 
-                                fieldInstance.field = fields.at(name);
+                                ScriptFieldInstance& fieldInstance = entityFields[field->index];
 
                                 switch (type) {
                                     READ_SCRIPT_FIELD(Float,    float);
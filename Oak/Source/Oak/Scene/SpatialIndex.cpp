@@ -0,0 +1,43 @@
+#include "oakpch.hpp"
+#include "SpatialIndex.hpp"
+
+namespace oak {
+    static size_t entityIndex(entt::entity entity)
+    {
+        return static_cast<size_t>(entt::registry::entity(entity));
+    }
+
+    void SpatialIndex::update(entt::entity entity, const glm::vec2& min, const glm::vec2& max)
+    {
+        const auto index = entityIndex(entity);
+        if (index >= m_Proxies.size()) {
+            m_Proxies.resize(index + 1, b2_nullNode);
+        }
+
+        b2AABB aabb;
+        aabb.lowerBound.Set(min.x, min.y);
+        aabb.upperBound.Set(max.x, max.y);
+
+        auto& proxy = m_Proxies[index];
+        if (proxy == b2_nullNode) {
+            proxy = m_Tree.CreateProxy(aabb, reinterpret_cast<void*>(static_cast<uintptr_t>(entity)));
+            m_Count++;
+        }
+        else {
+            // Only reinserts when the bounds left the fattened AABB
+            m_Tree.MoveProxy(proxy, aabb, b2Vec2_zero);
+        }
+    }
+
+    void SpatialIndex::remove(entt::entity entity)
+    {
+        const auto index = entityIndex(entity);
+        if (index >= m_Proxies.size() || m_Proxies[index] == b2_nullNode) {
+            return;
+        }
+
+        m_Tree.DestroyProxy(m_Proxies[index]);
+        m_Proxies[index] = b2_nullNode;
+        m_Count--;
+    }
+}
@@ -0,0 +1,57 @@
+#pragma once
+
+#include <glm/glm.hpp>
+
+#include "entt.hpp"
+
+#include "box2d/b2_dynamic_tree.h"
+
+namespace oak {
+    // Broadphase over entity bounds in the XY plane, backed by Box2D's dynamic AABB tree.
+    // The tree stores fattened bounds, so small movements do not restructure it and
+    // queries may return a few entities just outside the region.
+    class SpatialIndex
+    {
+    public:
+        // Inserts the entity or moves its bounds
+        void update(entt::entity entity, const glm::vec2& min, const glm::vec2& max);
+        void remove(entt::entity entity);
+
+        uint32_t getCount() const { return m_Count; }
+
+        // Calls `callback(entity)` for each candidate, returning false from it stops the query
+        template<typename Func>
+        void queryRegion(const glm::vec2& min, const glm::vec2& max, Func&& callback) const
+        {
+            struct Visitor
+            {
+                const b2DynamicTree* tree;
+                Func* callback;
+
+                bool QueryCallback(int32 proxyId)
+                {
+                    auto entity = static_cast<entt::entity>(reinterpret_cast<uintptr_t>(tree->GetUserData(proxyId)));
+                    return (*callback)(entity);
+                }
+            };
+
+            b2AABB aabb;
+            aabb.lowerBound.Set(min.x, min.y);
+            aabb.upperBound.Set(max.x, max.y);
+
+            Visitor visitor{ &m_Tree, &callback };
+            m_Tree.Query(&visitor, aabb);
+        }
+
+        template<typename Func>
+        void queryPoint(const glm::vec2& point, Func&& callback) const
+        {
+            queryRegion(point, point, std::forward<Func>(callback));
+        }
+
+    private:
+        b2DynamicTree m_Tree;
+        std::vector<int32_t> m_Proxies; // Indexed by entity number, without the version
+        uint32_t m_Count = 0;
+    };
+}
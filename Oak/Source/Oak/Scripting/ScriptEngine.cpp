@@ -9,9 +9,16 @@
 #include "mono/metadata/tabledefs.h"
 #include "mono/metadata/mono-debug.h"
 #include "mono/metadata/threads.h"
+#include "mono/metadata/mono-gc.h"
+#include "mono/metadata/reflection.h"
 
 #include "FileWatch.h"
 
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
 #include "Oak/Core/Application.hpp"
 #include "Oak/Core/Timer.hpp"
 #include "Oak/Core/Buffer.hpp"
@@ -42,17 +49,47 @@ namespace oak {
     };
 
     namespace utils {
-        static MonoAssembly* loadMonoAssembly(const std::filesystem::path& assemblyPath, bool loadPDB = false)
+        struct TypeName
+        {
+            std::string nameSpace;
+            std::string name;
+        };
+
+        // The image is opened from a private copy of the assembly, so rebuilding the original while the
+        // editor runs neither fails on a locked file nor changes pages under a loaded image
+        static Ref<MappedFile> mapAssemblyCopy(const std::filesystem::path& assemblyPath)
         {
-            ScopedBuffer fileData = oak::FileSystem::readFileBinary(assemblyPath);
+            std::error_code error;
+            auto directory = std::filesystem::temp_directory_path(error) / "Oak" / "Scripts";
+            std::filesystem::create_directories(directory, error);
+
+            auto copyPath = directory / fmt::format("{}-{}{}", assemblyPath.stem().string(), (uint64_t)UUID(), assemblyPath.extension().string());
+            if (!std::filesystem::copy_file(assemblyPath, copyPath, std::filesystem::copy_options::overwrite_existing, error)) {
+                OAK_LOG_CORE_ERROR("[ScriptEngine] Could not copy {}: {}", assemblyPath, error.message());
+                return nullptr;
+            }
+
+            auto file = createRef<MappedFile>(copyPath, true);
+            return *file ? file : nullptr;
+        }
+
+        // Only opens the image, so it can run on any thread attached to Mono. The assembly is loaded
+        // into the current domain by loadMonoAssembly. The image reads straight from `outFile`,
+        // which has to outlive it
+        static MonoImage* openMonoImage(const std::filesystem::path& assemblyPath, bool loadPDB, Ref<MappedFile>& outFile)
+        {
+            outFile = mapAssemblyCopy(assemblyPath);
+            if (!outFile) {
+                return nullptr;
+            }
 
             // NOTE: We can't use this image for anything other than loading the assembly because this image doesn't have a reference to the assembly
             MonoImageOpenStatus status;
-            MonoImage* image = mono_image_open_from_data_full(fileData.as<char>(), fileData.size(), 1, &status, 0);
+            MonoImage* image = mono_image_open_from_data_full(outFile->as<char>(), (uint32_t)outFile->size(), 0, &status, 0);
 
             if (status != MONO_IMAGE_OK) {
-                const char* errorMessage = mono_image_strerror(status);
-                // Log some error message using the errorMessage data
+                outFile = nullptr;
+                OAK_LOG_CORE_ERROR("[ScriptEngine] Could not open {}: {}", assemblyPath, mono_image_strerror(status));
                 return nullptr;
             }
 
@@ -61,12 +98,18 @@ namespace oak {
                 pdbPath.replace_extension(".pdb");
 
                 if (std::filesystem::exists(pdbPath)) {
-                    ScopedBuffer pdbFileData = oak::FileSystem::readFileBinary(pdbPath);
-                    mono_debug_open_image_from_memory(image, pdbFileData.as<const mono_byte>(), pdbFileData.size());
+                    MappedFile pdbFile(pdbPath);
+                    mono_debug_open_image_from_memory(image, pdbFile.as<const mono_byte>(), (int)pdbFile.size());
                     OAK_LOG_CORE_INFO("Loaded PDB {}", pdbPath);
                 }
             }
 
+            return image;
+        }
+
+        static MonoAssembly* loadMonoAssembly(MonoImage* image, const std::filesystem::path& assemblyPath)
+        {
+            MonoImageOpenStatus status;
             std::string pathString = assemblyPath.string();
             MonoAssembly* assembly = mono_assembly_load_from_full(image, pathString.c_str(), &status, 0);
             mono_image_close(image);
@@ -74,6 +117,31 @@ namespace oak {
             return assembly;
         }
 
+        static MonoAssembly* loadMonoAssembly(const std::filesystem::path& assemblyPath, bool loadPDB, Ref<MappedFile>& outFile)
+        {
+            MonoImage* image = openMonoImage(assemblyPath, loadPDB, outFile);
+            return image ? loadMonoAssembly(image, assemblyPath) : nullptr;
+        }
+
+        static std::vector<TypeName> getTypeNames(MonoImage* image)
+        {
+            const MonoTableInfo* typeDefinitionsTable = mono_image_get_table_info(image, MONO_TABLE_TYPEDEF);
+            int32_t numTypes = mono_table_info_get_rows(typeDefinitionsTable);
+
+            std::vector<TypeName> types;
+            types.reserve(numTypes);
+            for (int32_t i = 0; i < numTypes; i++) {
+                uint32_t cols[MONO_TYPEDEF_SIZE];
+                mono_metadata_decode_row(typeDefinitionsTable, i, cols, MONO_TYPEDEF_SIZE);
+
+                const char* nameSpace = mono_metadata_string_heap(image, cols[MONO_TYPEDEF_NAMESPACE]);
+                const char* name = mono_metadata_string_heap(image, cols[MONO_TYPEDEF_NAME]);
+                types.push_back({ nameSpace, name });
+            }
+
+            return types;
+        }
+
         void printAssemblyTypes(MonoAssembly* assembly)
         {
             MonoImage* image = mono_assembly_get_image(assembly);
@@ -90,6 +158,25 @@ namespace oak {
             }
         }
 
+        static void logException(MonoObject* exception)
+        {
+            if (!exception) {
+                return;
+            }
+
+            MonoString* message = mono_object_to_string(exception, nullptr);
+            char* text = message ? mono_string_to_utf8(message) : nullptr;
+            OAK_LOG_CORE_ERROR("[ScriptEngine] {}", text ? text : "Unhandled managed exception");
+            mono_free(text);
+        }
+
+        template<typename T>
+        static T getMethodThunk(MonoClass* monoClass, const char* name, int parameterCount)
+        {
+            auto* method = mono_class_get_method_from_name(monoClass, name, parameterCount);
+            return method ? reinterpret_cast<T>(mono_method_get_unmanaged_thunk(method)) : nullptr;
+        }
+
         ScriptFieldType monoTypeToScriptFieldType(MonoType* monoType)
         {
             std::string typeName = mono_type_get_name(monoType);
@@ -104,6 +191,124 @@ namespace oak {
         }
     }
 
+    // Threads attached to Mono that run chunks of [ThreadSafeUpdate] script updates
+    class ScriptWorkerPool
+    {
+    public:
+        explicit ScriptWorkerPool(uint32_t threadCount)
+        {
+            for (uint32_t i = 0; i < threadCount; i++) {
+                m_Threads.emplace_back([this]() { workerLoop(); });
+            }
+        }
+
+        ~ScriptWorkerPool()
+        {
+            {
+                std::scoped_lock<std::mutex> lock(m_Mutex);
+                m_Stopping = true;
+            }
+            m_WorkReady.notify_all();
+
+            for (auto& thread : m_Threads) {
+                thread.join();
+            }
+        }
+
+        uint32_t getThreadCount() const { return (uint32_t)m_Threads.size(); }
+
+        // Calls job(i) for every i below jobCount on the workers and the calling thread, returns once all are done.
+        // Workers run in `domain` for the duration
+        void run(MonoDomain* domain, uint32_t jobCount, const std::function<void(uint32_t)>& job)
+        {
+            {
+                std::scoped_lock<std::mutex> lock(m_Mutex);
+                m_Domain = domain;
+                m_Job = &job;
+                m_JobCount = jobCount;
+                m_NextJob = 0;
+                m_ActiveWorkers = (uint32_t)m_Threads.size();
+                m_Generation++;
+            }
+            m_WorkReady.notify_all();
+
+            runJobs();
+
+            std::unique_lock<std::mutex> lock(m_Mutex);
+            m_WorkDone.wait(lock, [this]() { return m_ActiveWorkers == 0; });
+            m_Job = nullptr;
+        }
+
+    private:
+        void workerLoop()
+        {
+            mono_thread_attach(mono_get_root_domain());
+
+            uint64_t generation = 0;
+            while (true) {
+                std::unique_lock<std::mutex> lock(m_Mutex);
+                m_WorkReady.wait(lock, [&]() { return m_Stopping || m_Generation != generation; });
+                if (m_Stopping) {
+                    break;
+                }
+
+                generation = m_Generation;
+                auto* domain = m_Domain;
+                lock.unlock();
+
+                // Back to the root domain afterwards, so the app domain can be unloaded on reload
+                mono_domain_set(domain, false);
+                runJobs();
+                mono_domain_set(mono_get_root_domain(), false);
+
+                lock.lock();
+                if (--m_ActiveWorkers == 0) {
+                    m_WorkDone.notify_one();
+                }
+            }
+
+            mono_thread_detach(mono_thread_current());
+        }
+
+        void runJobs()
+        {
+            for (auto i = m_NextJob.fetch_add(1); i < m_JobCount; i = m_NextJob.fetch_add(1)) {
+                (*m_Job)(i);
+            }
+        }
+
+    private:
+        std::vector<std::thread> m_Threads;
+        std::mutex m_Mutex;
+        std::condition_variable m_WorkReady;
+        std::condition_variable m_WorkDone;
+
+        MonoDomain* m_Domain = nullptr;
+        const std::function<void(uint32_t)>* m_Job = nullptr;
+        uint32_t m_JobCount = 0;
+        std::atomic<uint32_t> m_NextJob = 0;
+        uint32_t m_ActiveWorkers = 0;
+        uint64_t m_Generation = 0;
+        bool m_Stopping = false;
+    };
+
+    // Images opened by the reload worker, turned into assemblies at the next frame boundary
+    struct PreparedAssemblies
+    {
+        MonoImage* coreImage = nullptr;
+        MonoImage* appImage = nullptr;
+        Ref<MappedFile> coreFile;
+        Ref<MappedFile> appFile;
+        std::vector<utils::TypeName> appTypes;
+    };
+
+    // The index alone is reused once an entity is destroyed, the full handle tells a recycled slot apart
+    struct EntityInstanceSlot
+    {
+        entt::entity entity = entt::null;
+        Ref<ScriptInstance> instance;
+    };
+
     struct ScriptEngineData
     {
         MonoDomain* rootDomain = nullptr;
@@ -114,19 +319,31 @@ namespace oak {
 
         MonoAssembly* appAssembly = nullptr;
         MonoImage* appAssemblyImage = nullptr;
+        std::vector<utils::TypeName> appTypes;
+
+        // Backing memory of the loaded images, released only after their domain is unloaded
+        Ref<MappedFile> coreAssemblyFile;
+        Ref<MappedFile> appAssemblyFile;
 
         std::filesystem::path coreAssemblyFilepath;
         std::filesystem::path appAssemblyFilepath;
 
         ScriptClass EntityClass;
+        EntityConstructorThunk entityConstructorThunk = nullptr;
+        MonoClass* updateBatchClass = nullptr;
+        MonoMethod* createUpdateBatchMethod = nullptr;
 
         std::unordered_map<std::string, Ref<ScriptClass>> entityClasses;
-        std::unordered_map<oak::UUID, Ref<ScriptInstance>> entityInstances;
-        std::unordered_map<oak::UUID, ScriptFieldMap> entityScriptFields;
+        std::vector<EntityInstanceSlot> entityInstances; // Indexed by the entt entity index of the running scene
+        std::unordered_map<std::string, ScriptFieldStorage> fieldStorage; // By full class name, kept across assembly reloads
 
         Scope<filewatch::FileWatch<std::string>> appAssemblyFileWatcher;
         bool assemblyReloadPending = false;
 
+        std::thread reloadThread;
+        bool reloadInProgress = false;
+        PreparedAssemblies preparedReload;
+
 #ifdef HZ_DEBUG
         bool enableDebugging = true;
 #else
@@ -135,9 +352,51 @@ namespace oak {
         // Runtime
 
         Scene* sceneContext = nullptr;
+
+        // Stats
+        uint32_t gcCollectionsAtReset = 0;
+
+        // GC
+        struct CachedString
+        {
+            uint32_t handle = 0; // GC handle, 0 when unset
+            std::string value;
+        };
+        std::vector<CachedString> cachedStrings; // Indexed by the entt entity index, see getCachedString
+        uint32_t gcCollectThreshold = 0;
+        int64_t gcUsedSizeAtCollect = 0;
+
+        // Parallel update
+        MonoClass* threadSafeUpdateAttribute = nullptr;
+        Scope<ScriptWorkerPool> workerPool;
+        std::vector<ScriptCommandBuffer> commandBuffers; // One per chunk, applied in chunk order
     };
 
     static ScriptEngineData* s_Data = nullptr;
+    static thread_local ScriptCommandBuffer* s_CommandBuffer = nullptr;
+
+    // Smallest number of instances worth handing to another thread
+    static constexpr int32_t s_MinUpdateChunkSize = 64;
+
+    static size_t entityIndex(entt::entity entity)
+    {
+        return static_cast<size_t>(entt::registry::entity(entity));
+    }
+
+    static Ref<ScriptInstance>* findEntityInstance(entt::entity entity)
+    {
+        const auto index = entityIndex(entity);
+        if (index >= s_Data->entityInstances.size()) {
+            return nullptr;
+        }
+
+        auto& slot = s_Data->entityInstances[index];
+        if (slot.entity != entity || !slot.instance) {
+            return nullptr;
+        }
+
+        return &slot.instance;
+    }
 
     static void onAppAssemblyFileSystemEvent(const std::string& path, const filewatch::Event change_type)
     {
@@ -177,10 +436,15 @@ namespace oak {
 
         // Retrieve and instantiate class
         s_Data->EntityClass = ScriptClass("Oak", "Entity", true);
+        s_Data->entityConstructorThunk = utils::getMethodThunk<EntityConstructorThunk>(s_Data->EntityClass.m_MonoClass, ".ctor", 2);
     }
 
     void ScriptEngine::shutdown()
     {
+        if (s_Data->reloadThread.joinable()) {
+            s_Data->reloadThread.join();
+        }
+
         shutdownMono();
         delete s_Data;
     }
@@ -189,6 +453,18 @@ namespace oak {
     {
         mono_set_assemblies_path("mono/lib");
 
+        // SGen only reads its parameters once, when the runtime starts
+        const auto& config = oak::Project::getActive()->getConfig();
+        if (config.scriptNurserySize > 0) {
+            const auto gcParams = fmt::format("nursery-size={}k", config.scriptNurserySize / 1024);
+#ifdef OAK_PLATFORM_WINDOWS
+            _putenv_s("MONO_GC_PARAMS", gcParams.c_str());
+#else
+            setenv("MONO_GC_PARAMS", gcParams.c_str(), 1);
+#endif
+        }
+        s_Data->gcCollectThreshold = config.scriptCollectThreshold;
+
         if (s_Data->enableDebugging) {
             const char* argv[2] = {
                 "--debugger-agent=transport=dt_socket,address=127.0.0.1:2550,server=y,suspend=n,loglevel=3,logfile=MonoDebugger.log",
@@ -210,10 +486,19 @@ namespace oak {
         }
 
         mono_thread_set_main(mono_thread_current());
+
+        // The main thread takes a share of every parallel update too
+        const auto workerCount = std::max(std::thread::hardware_concurrency(), 2u) - 1;
+        s_Data->workerPool = createScope<ScriptWorkerPool>(workerCount);
     }
 
     void ScriptEngine::shutdownMono()
     {
+        s_Data->workerPool.reset();
+
+        releaseUpdateBatches();
+        releaseCachedStrings();
+
         mono_domain_set(mono_get_root_domain(), false);
 
         mono_domain_unload(s_Data->appDomain);
@@ -230,7 +515,7 @@ namespace oak {
         mono_domain_set(s_Data->appDomain, true);
 
         s_Data->coreAssemblyFilepath = filepath;
-        s_Data->coreAssembly = utils::loadMonoAssembly(filepath, s_Data->enableDebugging);
+        s_Data->coreAssembly = utils::loadMonoAssembly(filepath, s_Data->enableDebugging, s_Data->coreAssemblyFile);
         if (s_Data->coreAssembly == nullptr)
             return false;
 
@@ -241,12 +526,13 @@ namespace oak {
     bool ScriptEngine::loadAppAssembly(const std::filesystem::path& filepath)
     {
         s_Data->appAssemblyFilepath = filepath;
-        s_Data->appAssembly = utils::loadMonoAssembly(filepath, s_Data->enableDebugging);
+        s_Data->appAssembly = utils::loadMonoAssembly(filepath, s_Data->enableDebugging, s_Data->appAssemblyFile);
         if (s_Data->appAssembly == nullptr) {
             return false;
         }
 
         s_Data->appAssemblyImage = mono_assembly_get_image(s_Data->appAssembly);
+        s_Data->appTypes = utils::getTypeNames(s_Data->appAssemblyImage);
 
         s_Data->appAssemblyFileWatcher = createScope<filewatch::FileWatch<std::string>>(filepath.string(), onAppAssemblyFileSystemEvent);
         s_Data->assemblyReloadPending = false;
@@ -255,18 +541,98 @@ namespace oak {
 
     void ScriptEngine::reloadAssembly()
     {
+        if (s_Data->reloadInProgress) {
+            return;
+        }
+
+        if (s_Data->reloadThread.joinable()) {
+            s_Data->reloadThread.join();
+        }
+
+        // Reading and opening the images is the slow part, it runs on a worker while the editor keeps drawing
+        s_Data->reloadInProgress = true;
+        s_Data->reloadThread = std::thread([coreFilepath = s_Data->coreAssemblyFilepath, appFilepath = s_Data->appAssemblyFilepath, loadPDB = s_Data->enableDebugging]() {
+            OAK_PROFILE_SCOPE("ScriptEngine::reloadAssembly worker");
+
+            mono_thread_attach(s_Data->rootDomain);
+
+            PreparedAssemblies prepared;
+            prepared.coreImage = utils::openMonoImage(coreFilepath, loadPDB, prepared.coreFile);
+            prepared.appImage = utils::openMonoImage(appFilepath, loadPDB, prepared.appFile);
+            if (prepared.appImage) {
+                prepared.appTypes = utils::getTypeNames(prepared.appImage);
+            }
+
+            mono_thread_detach(mono_thread_current());
+
+            oak::Application::get().submitToMainThread([prepared = std::move(prepared)]() mutable {
+                s_Data->preparedReload = std::move(prepared);
+                ScriptEngine::swapAssemblies();
+            });
+        });
+    }
+
+    void ScriptEngine::swapAssemblies()
+    {
+        OAK_PROFILE_FUNCTION();
+
+        Timer timer;
+
+        s_Data->reloadThread.join();
+        s_Data->reloadInProgress = false;
+
+        auto prepared = std::move(s_Data->preparedReload);
+        s_Data->preparedReload = {};
+        if (!prepared.coreImage || !prepared.appImage) {
+            OAK_LOG_CORE_ERROR("[ScriptEngine] Assembly reload failed, keeping the loaded assemblies.");
+            if (prepared.coreImage) {
+                mono_image_close(prepared.coreImage);
+            }
+            if (prepared.appImage) {
+                mono_image_close(prepared.appImage);
+            }
+
+            s_Data->appAssemblyFileWatcher = createScope<filewatch::FileWatch<std::string>>(s_Data->appAssemblyFilepath.string(), onAppAssemblyFileSystemEvent);
+            s_Data->assemblyReloadPending = false;
+            return;
+        }
+
+        // GC handles have to be freed while their domain is still alive. Instances of a running scene
+        // belong to the old domain and cannot survive the swap
+        s_Data->entityInstances.clear();
+        releaseUpdateBatches();
+        releaseCachedStrings();
+
         mono_domain_set(mono_get_root_domain(), false);
 
         mono_domain_unload(s_Data->appDomain);
 
-        loadAssembly(s_Data->coreAssemblyFilepath);
-        loadAppAssembly(s_Data->appAssemblyFilepath);
+        s_Data->appDomain = mono_domain_create_appdomain(const_cast<char*>("OakScriptRuntime"), nullptr);
+        mono_domain_set(s_Data->appDomain, true);
+
+        s_Data->coreAssemblyFile = prepared.coreFile;
+        s_Data->appAssemblyFile = prepared.appFile;
+
+        s_Data->coreAssembly = utils::loadMonoAssembly(prepared.coreImage, s_Data->coreAssemblyFilepath);
+        s_Data->coreAssemblyImage = mono_assembly_get_image(s_Data->coreAssembly);
+
+        s_Data->appAssembly = utils::loadMonoAssembly(prepared.appImage, s_Data->appAssemblyFilepath);
+        s_Data->appAssemblyImage = mono_assembly_get_image(s_Data->appAssembly);
+        s_Data->appTypes = std::move(prepared.appTypes);
+
+        s_Data->appAssemblyFileWatcher = createScope<filewatch::FileWatch<std::string>>(s_Data->appAssemblyFilepath.string(), onAppAssemblyFileSystemEvent);
+        s_Data->assemblyReloadPending = false;
+
+        // Field values live in the per-class storage, which survives the reload
         loadAssemblyClasses();
 
         ScriptGlue::registerComponents();
 
         // Retrieve and instantiate class
         s_Data->EntityClass = ScriptClass("Oak", "Entity", true);
+        s_Data->entityConstructorThunk = utils::getMethodThunk<EntityConstructorThunk>(s_Data->EntityClass.m_MonoClass, ".ctor", 2);
+
+        OAK_LOG_CORE_INFO("[ScriptEngine] Assembly reload stalled the main thread for {} ms", timer.elapsedMillis());
     }
 
     void ScriptEngine::onRuntimeStart(Scene* scene)
@@ -281,51 +647,175 @@ namespace oak {
 
     void ScriptEngine::onCreateEntity(oak::Entity entity)
     {
+        OAK_PROFILE_FUNCTION();
+
         const auto& sc = entity.getComponent<oak::ScriptComponent>();
         if (ScriptEngine::entityClassExists(sc.className))
         {
             auto entityID = entity.getUUID();
 
             Ref<ScriptInstance> instance = createRef<ScriptInstance>(s_Data->entityClasses[sc.className], entity);
-            s_Data->entityInstances[entityID] = instance;
+            const auto index = entityIndex(entity);
+            if (index >= s_Data->entityInstances.size()) {
+                s_Data->entityInstances.resize(index + 1);
+            }
+            s_Data->entityInstances[index] = { entity, instance };
 
             // Copy field values
-            if (s_Data->entityScriptFields.find(entityID) != s_Data->entityScriptFields.end()) {
-                const ScriptFieldMap& fieldMap = s_Data->entityScriptFields.at(entityID);
-                for (const auto& [name, fieldInstance] : fieldMap) {
-                    instance->setFieldValueInternal(name, fieldInstance.m_Buffer);
+            auto& scriptClass = *instance->getScriptClass();
+            if (const auto* values = scriptClass.m_FieldStorage->findFields(entityID)) {
+                for (const auto& field : scriptClass.m_Fields) {
+                    if (values[field.index].isSet()) {
+                        instance->setFieldValueInternal(field, values[field.index].m_Buffer);
+                    }
                 }
             }
 
+            // Add to the class's batch before OnCreate, which may already destroy the entity
+            if (scriptClass.m_UpdateBatchHandle) {
+                auto size = (uint32_t)scriptClass.m_BatchedEntities.size();
+                if (size == scriptClass.m_InstanceArrayCapacity) {
+                    const auto capacity = std::max(size * 2, 16u);
+                    auto* instances = mono_array_new(s_Data->appDomain, s_Data->EntityClass.m_MonoClass, capacity);
+                    if (scriptClass.m_InstanceArrayHandle) {
+                        auto* previous = (MonoArray*)mono_gchandle_get_target(scriptClass.m_InstanceArrayHandle);
+                        for (uint32_t i = 0; i < size; i++) {
+                            mono_array_setref(instances, i, mono_array_get(previous, MonoObject*, i));
+                        }
+                        mono_gchandle_free(scriptClass.m_InstanceArrayHandle);
+                    }
+
+                    scriptClass.m_InstanceArrayHandle = mono_gchandle_new((MonoObject*)instances, false);
+                    scriptClass.m_InstanceArrayCapacity = capacity;
+                }
+
+                auto* instances = (MonoArray*)mono_gchandle_get_target(scriptClass.m_InstanceArrayHandle);
+                mono_array_setref(instances, size, instance->getManagedObject());
+                instance->m_BatchIndex = size;
+                scriptClass.m_BatchedEntities.push_back(entity);
+            }
+
+            scriptClass.m_Stats.instanceCount++;
             instance->invokeOnCreate();
         }
     }
 
     void ScriptEngine::onUpdateEntity(oak::Entity entity, Timestep ts)
     {
-        auto entityUUID = entity.getUUID();
-        if (s_Data->entityInstances.find(entityUUID) != s_Data->entityInstances.end()) {
-            Ref<ScriptInstance> instance = s_Data->entityInstances[entityUUID];
-            instance->invokeOnUpdate((float)ts);
+        OAK_PROFILE_FUNCTION();
+
+        if (auto* instance = findEntityInstance(entity)) {
+            (*instance)->invokeOnUpdate((float)ts);
         }
         else {
-            OAK_LOG_CORE_ERROR("Could not find ScriptInstance for entity {}",  entityUUID);
+            OAK_LOG_CORE_ERROR("Could not find ScriptInstance for entity {}", entity.getUUID());
         }
     }
 
-    Scene* ScriptEngine::getSceneContext()
+    void ScriptEngine::onUpdateEntities(Timestep ts)
     {
-        return s_Data->sceneContext;
+        OAK_PROFILE_FUNCTION();
+
+        auto timestep = (float)ts;
+        for (const auto& [name, scriptClass] : s_Data->entityClasses) {
+            if (!scriptClass->m_UpdateBatchHandle || scriptClass->m_BatchedEntities.empty()) {
+                continue;
+            }
+
+            auto* batch = mono_gchandle_get_target(scriptClass->m_UpdateBatchHandle);
+            auto* instances = mono_gchandle_get_target(scriptClass->m_InstanceArrayHandle);
+            auto count = (int32_t)scriptClass->m_BatchedEntities.size();
+
+            Timer timer;
+            if (scriptClass->m_ThreadSafeUpdate && count >= s_MinUpdateChunkSize * 2) {
+                updateBatchParallel(*scriptClass, batch, (MonoArray*)instances, count, timestep);
+            }
+            else {
+                MonoException* exception = nullptr;
+                scriptClass->m_UpdateBatchThunk(batch, (MonoArray*)instances, 0, count, timestep, &exception);
+                utils::logException((MonoObject*)exception);
+            }
+            scriptClass->m_Stats.onUpdateTime += timer.elapsedMillis();
+            scriptClass->m_Stats.onUpdateCalls += count;
+        }
     }
 
-    Ref<ScriptInstance> ScriptEngine::getEntityScriptInstance(oak::UUID entityID)
+    void ScriptEngine::updateBatchParallel(ScriptClass& scriptClass, MonoObject* batch, MonoArray* instances, int32_t count, float ts)
     {
-        auto it = s_Data->entityInstances.find(entityID);
-        if (it == s_Data->entityInstances.end()) {
-            return nullptr;
+        OAK_PROFILE_FUNCTION();
+
+        auto& pool = *s_Data->workerPool;
+        const auto chunkCount = std::min(pool.getThreadCount() + 1, (uint32_t)(count / s_MinUpdateChunkSize));
+        const auto chunkSize = (count + (int32_t)chunkCount - 1) / (int32_t)chunkCount;
+
+        auto& commandBuffers = s_Data->commandBuffers;
+        if (commandBuffers.size() < chunkCount) {
+            commandBuffers.resize(chunkCount);
+        }
+
+        // Contiguous chunks, so applying the buffers in chunk order matches a serial update
+        pool.run(s_Data->appDomain, chunkCount, [&](uint32_t chunk) {
+            const auto first = (int32_t)chunk * chunkSize;
+            const auto chunkLength = std::min(chunkSize, count - first);
+            if (chunkLength <= 0) {
+                return;
+            }
+
+            s_CommandBuffer = &commandBuffers[chunk];
+            MonoException* exception = nullptr;
+            scriptClass.m_UpdateBatchThunk(batch, instances, first, chunkLength, ts, &exception);
+            utils::logException((MonoObject*)exception);
+            s_CommandBuffer = nullptr;
+        });
+
+        for (uint32_t i = 0; i < chunkCount; i++) {
+            for (auto& command : commandBuffers[i]) {
+                command();
+            }
+            commandBuffers[i].clear();
         }
+    }
 
-        return it->second;
+    ScriptCommandBuffer* ScriptEngine::getCommandBuffer()
+    {
+        return s_CommandBuffer;
+    }
+
+    void ScriptEngine::onDestroyEntity(oak::Entity entity)
+    {
+        auto* entityInstance = findEntityInstance(entity);
+        if (!entityInstance) {
+            return;
+        }
+
+        // Swap-remove from the class's batch so the instance array stays dense
+        auto& instance = **entityInstance;
+        auto& scriptClass = *instance.getScriptClass();
+        scriptClass.m_Stats.instanceCount--;
+        if (scriptClass.m_UpdateBatchHandle) {
+            auto* instances = (MonoArray*)mono_gchandle_get_target(scriptClass.m_InstanceArrayHandle);
+            const auto last = (uint32_t)scriptClass.m_BatchedEntities.size() - 1;
+            const auto lastEntity = scriptClass.m_BatchedEntities[last];
+
+            mono_array_setref(instances, instance.m_BatchIndex, mono_array_get(instances, MonoObject*, last));
+            mono_array_setref(instances, last, nullptr);
+            scriptClass.m_BatchedEntities[instance.m_BatchIndex] = lastEntity;
+            scriptClass.m_BatchedEntities.pop_back();
+            (*findEntityInstance(lastEntity))->m_BatchIndex = instance.m_BatchIndex;
+        }
+
+        entityInstance->reset();
+    }
+
+    Scene* ScriptEngine::getSceneContext()
+    {
+        return s_Data->sceneContext;
+    }
+
+    Ref<ScriptInstance> ScriptEngine::getEntityScriptInstance(oak::Entity entity)
+    {
+        auto* instance = findEntityInstance(entity);
+        return instance ? *instance : nullptr;
     }
 
 
@@ -342,7 +832,18 @@ namespace oak {
     {
         s_Data->sceneContext = nullptr;
 
+        for (auto& [name, scriptClass] : s_Data->entityClasses) {
+            if (scriptClass->m_InstanceArrayHandle) {
+                mono_gchandle_free(scriptClass->m_InstanceArrayHandle);
+            }
+            scriptClass->m_InstanceArrayHandle = 0;
+            scriptClass->m_InstanceArrayCapacity = 0;
+            scriptClass->m_BatchedEntities.clear();
+            scriptClass->m_Stats.instanceCount = 0;
+        }
+
         s_Data->entityInstances.clear();
+        releaseCachedStrings();
     }
 
     std::unordered_map<std::string, Ref<ScriptClass>> ScriptEngine::getEntityClasses()
@@ -350,28 +851,47 @@ namespace oak {
         return s_Data->entityClasses;
     }
 
-    ScriptFieldMap& ScriptEngine::getScriptFieldMap(oak::Entity entity)
+    static ScriptFieldStorage* findFieldStorage(oak::Entity entity)
     {
         OAK_CORE_ASSERT(entity);
 
-        auto entityID = entity.getUUID();
-        return s_Data->entityScriptFields[entityID];
+        const auto& sc = entity.getComponent<oak::ScriptComponent>();
+        auto it = s_Data->entityClasses.find(sc.className);
+        if (it == s_Data->entityClasses.end()) {
+            return nullptr;
+        }
+
+        return it->second->getFieldStorage();
+    }
+
+    ScriptFieldInstance* ScriptEngine::getScriptFields(oak::Entity entity)
+    {
+        auto* storage = findFieldStorage(entity);
+        return storage ? storage->getFields(entity.getUUID()) : nullptr;
+    }
+
+    ScriptFieldInstance* ScriptEngine::findScriptFields(oak::Entity entity)
+    {
+        auto* storage = findFieldStorage(entity);
+        return storage ? storage->findFields(entity.getUUID()) : nullptr;
     }
 
     void ScriptEngine::loadAssemblyClasses()
     {
+        releaseUpdateBatches();
         s_Data->entityClasses.clear();
 
-        const auto* typeDefinitionsTable = mono_image_get_table_info(s_Data->appAssemblyImage, MONO_TABLE_TYPEDEF);
-        int32_t numTypes = mono_table_info_get_rows(typeDefinitionsTable);
-        auto* entityClass = mono_class_from_name(s_Data->coreAssemblyImage, "Oak", "Entity");
+        s_Data->updateBatchClass = mono_class_from_name(s_Data->coreAssemblyImage, "Oak", "ScriptUpdateBatch");
+        s_Data->createUpdateBatchMethod = mono_class_get_method_from_name(s_Data->updateBatchClass, "Create", 1);
+        auto* updateBatchMethod = mono_class_get_method_from_name(s_Data->updateBatchClass, "Update", 4);
+        s_Data->threadSafeUpdateAttribute = mono_class_from_name(s_Data->coreAssemblyImage, "Oak", "ThreadSafeUpdateAttribute");
 
-        for (int32_t i = 0; i < numTypes; i++) {
-            uint32_t cols[MONO_TYPEDEF_SIZE];
-            mono_metadata_decode_row(typeDefinitionsTable, i, cols, MONO_TYPEDEF_SIZE);
+        auto* entityClass = mono_class_from_name(s_Data->coreAssemblyImage, "Oak", "Entity");
 
-            auto* nameSpace = mono_metadata_string_heap(s_Data->appAssemblyImage, cols[MONO_TYPEDEF_NAMESPACE]);
-            auto* className = mono_metadata_string_heap(s_Data->appAssemblyImage, cols[MONO_TYPEDEF_NAME]);
+        // Type names come from the metadata table, read when the app assembly was opened
+        for (const auto& type : s_Data->appTypes) {
+            auto* nameSpace = type.nameSpace.c_str();
+            auto* className = type.name.c_str();
             std::string fullName;
             if (strlen(nameSpace) != 0) {
                 fullName = fmt::format("{}.{}", nameSpace, className);
@@ -394,6 +914,14 @@ namespace oak {
             Ref<ScriptClass> scriptClass = createRef<ScriptClass>(nameSpace, className);
             s_Data->entityClasses[fullName] = scriptClass;
 
+            scriptClass->m_OnCreateThunk = utils::getMethodThunk<OnCreateThunk>(monoClass, "OnCreate", 0);
+            scriptClass->m_OnUpdateThunk = utils::getMethodThunk<OnUpdateThunk>(monoClass, "OnUpdate", 1);
+
+            if (auto* attributes = mono_custom_attrs_from_class(monoClass)) {
+                scriptClass->m_ThreadSafeUpdate = mono_custom_attrs_has_attr(attributes, s_Data->threadSafeUpdateAttribute);
+                mono_custom_attrs_free(attributes);
+            }
+
             // This routine is an iterator routine for retrieving the fields in a class.
             // You must pass a gpointer that points to zero and is treated as an opaque handle
             // to iterate over all of the elements. When no more values are available, the return value is NULL.
@@ -409,25 +937,152 @@ namespace oak {
                     ScriptFieldType fieldType = utils::monoTypeToScriptFieldType(type);
                     OAK_LOG_CORE_WARN("  {} ({})", fieldName, utils::scriptFieldTypeToString(fieldType));
 
-                    scriptClass->m_Fields[fieldName] = { fieldType, fieldName, field };
+                    scriptClass->m_Fields.push_back({ fieldType, fieldName, field, (uint32_t)scriptClass->m_Fields.size() });
                 }
             }
 
+            auto& fieldStorage = s_Data->fieldStorage[fullName];
+            fieldStorage.setLayout(scriptClass->m_Fields);
+            scriptClass->m_FieldStorage = &fieldStorage;
+
+            // Managed side of the batched OnUpdate dispatch
+            void* param = mono_type_get_object(s_Data->appDomain, mono_class_get_type(monoClass));
+            MonoObject* exception = nullptr;
+            auto* updateBatch = mono_runtime_invoke(s_Data->createUpdateBatchMethod, nullptr, &param, &exception);
+            if (updateBatch && !exception) {
+                scriptClass->m_UpdateBatchHandle = mono_gchandle_new(updateBatch, false);
+                scriptClass->m_UpdateBatchThunk = reinterpret_cast<UpdateBatchThunk>(mono_method_get_unmanaged_thunk(mono_object_get_virtual_method(updateBatch, updateBatchMethod)));
+            }
         }
 
         auto& entityClasses = s_Data->entityClasses;
     }
 
+    void ScriptEngine::releaseUpdateBatches()
+    {
+        for (auto& [name, scriptClass] : s_Data->entityClasses) {
+            if (scriptClass->m_UpdateBatchHandle) {
+                mono_gchandle_free(scriptClass->m_UpdateBatchHandle);
+                scriptClass->m_UpdateBatchHandle = 0;
+            }
+            if (scriptClass->m_InstanceArrayHandle) {
+                mono_gchandle_free(scriptClass->m_InstanceArrayHandle);
+                scriptClass->m_InstanceArrayHandle = 0;
+            }
+            scriptClass->m_InstanceArrayCapacity = 0;
+            scriptClass->m_BatchedEntities.clear();
+        }
+    }
+
     MonoImage* ScriptEngine::getCoreAssemblyImage()
     {
         return s_Data->coreAssemblyImage;
     }
 
 
-    MonoObject* ScriptEngine::getManagedInstance(oak::UUID uuid)
+    MonoObject* ScriptEngine::getManagedInstance(oak::Entity entity)
+    {
+        auto* instance = findEntityInstance(entity);
+        OAK_CORE_ASSERT(instance);
+        return (*instance)->getManagedObject();
+    }
+
+    MonoString* ScriptEngine::getCachedString(oak::Entity entity, const std::string& string)
+    {
+        // The cache belongs to the main thread, parallel updates get a fresh string
+        if (s_CommandBuffer) {
+            return createString(string.c_str());
+        }
+
+        const auto index = entityIndex(entity);
+        if (index >= s_Data->cachedStrings.size()) {
+            s_Data->cachedStrings.resize(index + 1);
+        }
+
+        // Managed strings are immutable, so handing out the same one again is safe
+        auto& cached = s_Data->cachedStrings[index];
+        if (cached.handle && cached.value == string) {
+            return (MonoString*)mono_gchandle_get_target(cached.handle);
+        }
+
+        if (cached.handle) {
+            mono_gchandle_free(cached.handle);
+        }
+
+        auto* managedString = createString(string.c_str());
+        cached.handle = mono_gchandle_new((MonoObject*)managedString, false);
+        cached.value = string;
+        return managedString;
+    }
+
+    void ScriptEngine::releaseCachedStrings()
+    {
+        for (auto& cached : s_Data->cachedStrings) {
+            if (cached.handle) {
+                mono_gchandle_free(cached.handle);
+            }
+        }
+
+        s_Data->cachedStrings.clear();
+    }
+
+    void ScriptEngine::collectGarbage(bool full)
+    {
+        OAK_PROFILE_FUNCTION();
+
+        mono_gc_collect(full ? mono_gc_max_generation() : 0);
+        s_Data->gcUsedSizeAtCollect = mono_gc_get_used_size();
+    }
+
+    void ScriptEngine::onSafePoint()
+    {
+        if (s_Data->gcCollectThreshold == 0) {
+            return;
+        }
+
+        if (mono_gc_get_used_size() - s_Data->gcUsedSizeAtCollect >= s_Data->gcCollectThreshold) {
+            collectGarbage();
+        }
+    }
+
+    static uint32_t getGCCollectionCount()
+    {
+        uint32_t count = 0;
+        for (int generation = 0; generation <= mono_gc_max_generation(); generation++) {
+            count += (uint32_t)mono_gc_collection_count(generation);
+        }
+
+        return count;
+    }
+
+    void ScriptEngine::resetStats()
+    {
+        for (auto& [name, scriptClass] : s_Data->entityClasses) {
+            const auto instanceCount = scriptClass->m_Stats.instanceCount;
+            scriptClass->m_Stats = {};
+            scriptClass->m_Stats.instanceCount = instanceCount;
+        }
+
+        ScriptGlue::resetInternalCallStatistics();
+        s_Data->gcCollectionsAtReset = getGCCollectionCount();
+    }
+
+    ScriptEngine::Statistics ScriptEngine::getStats()
     {
-        OAK_CORE_ASSERT(s_Data->entityInstances.find(uuid) != s_Data->entityInstances.end());
-        return s_Data->entityInstances.at(uuid)->getManagedObject();
+        Statistics stats;
+        for (const auto& [name, scriptClass] : s_Data->entityClasses) {
+            auto& classStats = stats.classes.emplace_back(scriptClass->m_Stats);
+            classStats.className = name;
+        }
+
+        // Most expensive first
+        std::sort(stats.classes.begin(), stats.classes.end(), [](const ScriptClassStatistics& a, const ScriptClassStatistics& b) {
+            return a.onCreateTime + a.onUpdateTime > b.onCreateTime + b.onUpdateTime;
+        });
+
+        ScriptGlue::getInternalCallStatistics(stats.internalCalls);
+        stats.gcCollections = getGCCollectionCount() - s_Data->gcCollectionsAtReset;
+        return stats;
     }
 
     MonoString* ScriptEngine::createString(const char* string)
@@ -435,6 +1090,11 @@ namespace oak {
         return mono_string_new(s_Data->appDomain, string);
     }
 
+    void ScriptEngine::logException(MonoObject* exception)
+    {
+        utils::logException(exception);
+    }
+
     MonoObject* ScriptEngine::instantiateClass(MonoClass* monoClass)
     {
         MonoObject* instance = mono_object_new(s_Data->appDomain, monoClass);
@@ -448,6 +1108,17 @@ namespace oak {
         m_MonoClass = mono_class_from_name(isCore ? s_Data->coreAssemblyImage : s_Data->appAssemblyImage, classNamespace.c_str(), className.c_str());
     }
 
+    const ScriptField* ScriptClass::findField(std::string_view name) const
+    {
+        for (const auto& field : m_Fields) {
+            if (field.name == name) {
+                return &field;
+            }
+        }
+
+        return nullptr;
+    }
+
     MonoObject* ScriptClass::instantiate()
     {
         return ScriptEngine::instantiateClass(m_MonoClass);
@@ -461,63 +1132,125 @@ namespace oak {
     MonoObject* ScriptClass::invokeMethod(MonoObject* instance, MonoMethod* method, void** params)
     {
         MonoObject* exception = nullptr;
-        return mono_runtime_invoke(method, instance, params, &exception);
+        auto* result = mono_runtime_invoke(method, instance, params, &exception);
+        utils::logException(exception);
+        return result;
     }
 
     ScriptInstance::ScriptInstance(Ref<ScriptClass> scriptClass, oak::Entity entity): m_ScriptClass(scriptClass)
     {
-        m_Instance = scriptClass->instantiate();
-
-        m_Constructor = s_Data->EntityClass.getMethod(".ctor", 1);
-        m_OnCreateMethod = scriptClass->getMethod("OnCreate", 0);
-        m_OnUpdateMethod = scriptClass->getMethod("OnUpdate", 1);
+        auto* instance = scriptClass->instantiate();
+        m_GCHandle = mono_gchandle_new(instance, false);
 
         // Call Entity constructor
         {
-            auto entityID = entity.getUUID();
-            void* param = &entityID;
-            m_ScriptClass->invokeMethod(m_Instance, m_Constructor, &param);
+            MonoException* exception = nullptr;
+            s_Data->entityConstructorThunk(instance, entity.getUUID(), (uint32_t)entity, &exception);
+            utils::logException((MonoObject*)exception);
         }
     }
 
+    ScriptInstance::~ScriptInstance()
+    {
+        mono_gchandle_free(m_GCHandle);
+    }
+
+    MonoObject* ScriptInstance::getManagedObject()
+    {
+        return mono_gchandle_get_target(m_GCHandle);
+    }
+
     void ScriptInstance::invokeOnCreate()
     {
-        if (m_OnCreateMethod) {
-            m_ScriptClass->invokeMethod(m_Instance, m_OnCreateMethod);
+        if (m_ScriptClass->m_OnCreateThunk) {
+            Timer timer;
+            MonoException* exception = nullptr;
+            m_ScriptClass->m_OnCreateThunk(getManagedObject(), &exception);
+            m_ScriptClass->m_Stats.onCreateTime += timer.elapsedMillis();
+            m_ScriptClass->m_Stats.onCreateCalls++;
+            utils::logException((MonoObject*)exception);
         }
     }
 
     void ScriptInstance::invokeOnUpdate(float ts)
     {
-        if (m_OnUpdateMethod) {
-            void* param = &ts;
-            m_ScriptClass->invokeMethod(m_Instance, m_OnUpdateMethod, &param);
+        if (m_ScriptClass->m_OnUpdateThunk) {
+            Timer timer;
+            MonoException* exception = nullptr;
+            m_ScriptClass->m_OnUpdateThunk(getManagedObject(), ts, &exception);
+            m_ScriptClass->m_Stats.onUpdateTime += timer.elapsedMillis();
+            m_ScriptClass->m_Stats.onUpdateCalls++;
+            utils::logException((MonoObject*)exception);
         }
     }
 
-    bool ScriptInstance::getFieldValueInternal(const std::string& name, void* buffer)
+    void ScriptInstance::getFieldValueInternal(const ScriptField& field, void* buffer)
     {
-        const auto& fields = m_ScriptClass->getFields();
-        auto it = fields.find(name);
-        if (it == fields.end()) {
-            return false;
+        mono_field_get_value(getManagedObject(), field.classField, buffer);
+    }
+
+    void ScriptInstance::setFieldValueInternal(const ScriptField& field, const void* value)
+    {
+        mono_field_set_value(getManagedObject(), field.classField, (void*)value);
+    }
+
+    ScriptFieldInstance* ScriptFieldStorage::findFields(oak::UUID entityID)
+    {
+        auto it = m_Rows.find(entityID);
+        if (it == m_Rows.end() || m_Layout.empty()) {
+            return nullptr;
         }
 
-        const ScriptField& field = it->second;
-        mono_field_get_value(m_Instance, field.classField, buffer);
-        return true;
+        return &m_Values[(size_t)it->second * m_Layout.size()];
     }
 
-    bool ScriptInstance::setFieldValueInternal(const std::string& name, const void* value)
+    ScriptFieldInstance* ScriptFieldStorage::getFields(oak::UUID entityID)
     {
-        const auto& fields = m_ScriptClass->getFields();
-        auto it = fields.find(name);
-        if (it == fields.end()) {
-            return false;
+        if (m_Layout.empty()) {
+            return nullptr;
         }
 
-        const ScriptField& field = it->second;
-        mono_field_set_value(m_Instance, field.classField, (void*)value);
-        return true;
+        auto [it, inserted] = m_Rows.try_emplace(entityID, (uint32_t)m_Rows.size());
+        if (inserted) {
+            m_Values.resize(m_Values.size() + m_Layout.size());
+        }
+
+        return &m_Values[(size_t)it->second * m_Layout.size()];
+    }
+
+    void ScriptFieldStorage::setLayout(const std::vector<ScriptField>& fields)
+    {
+        const auto unchanged = std::equal(m_Layout.begin(), m_Layout.end(), fields.begin(), fields.end(), [](const Column& column, const ScriptField& field) {
+            return column.name == field.name && column.type == field.type;
+        });
+        if (unchanged) {
+            return;
+        }
+
+        // Column of the old layout each new field takes its values from
+        std::vector<int32_t> sources(fields.size(), -1);
+        for (size_t i = 0; i < fields.size(); i++) {
+            for (size_t j = 0; j < m_Layout.size(); j++) {
+                if (m_Layout[j].name == fields[i].name && m_Layout[j].type == fields[i].type) {
+                    sources[i] = (int32_t)j;
+                    break;
+                }
+            }
+        }
+
+        std::vector<ScriptFieldInstance> values(m_Rows.size() * fields.size());
+        for (size_t row = 0; row < m_Rows.size(); row++) {
+            for (size_t i = 0; i < fields.size(); i++) {
+                if (sources[i] >= 0) {
+                    values[row * fields.size() + i] = m_Values[row * m_Layout.size() + sources[i]];
+                }
+            }
+        }
+
+        m_Layout.clear();
+        for (const auto& field : fields) {
+            m_Layout.push_back({ field.name, field.type });
+        }
+        m_Values = std::move(values);
     }
 }
@@ -4,8 +4,10 @@
 #include "Oak/Scene/Entity.hpp"
 
 #include <filesystem>
+#include <functional>
 #include <string>
-#include <map>
+#include <unordered_map>
+#include <vector>
 
 extern "C" {
     typedef struct _MonoClass MonoClass;
@@ -15,8 +17,17 @@ extern "C" {
     typedef struct _MonoImage MonoImage;
     typedef struct _MonoClassField MonoClassField;
     typedef struct _MonoString MonoString;
+    typedef struct _MonoArray MonoArray;
+    typedef struct _MonoException MonoException;
 }
 
+// Unmanaged thunks use the platform's stdcall convention
+#ifdef OAK_PLATFORM_WINDOWS
+    #define OAK_MONO_THUNK __stdcall
+#else
+    #define OAK_MONO_THUNK
+#endif
+
 namespace oak {
     enum class ScriptFieldType
     {
@@ -34,13 +45,12 @@ namespace oak {
         std::string name;
 
         MonoClassField* classField;
+        uint32_t index = 0; // Position in ScriptClass::getFields() and column in the class's ScriptFieldStorage
     };
 
-    // ScriptField + data storage
+    // Data storage for one field of one entity
     struct ScriptFieldInstance
     {
-        ScriptField field;
-
         ScriptFieldInstance()
         {
             memset(m_Buffer, 0, sizeof(m_Buffer));
@@ -58,16 +68,68 @@ namespace oak {
         {
             static_assert(sizeof(T) <= 16, "Type too large!");
             memcpy(m_Buffer, &value, sizeof(T));
+            m_IsSet = true;
         }
 
+        // Only fields set in the editor are copied to instances and serialized
+        bool isSet() const { return m_IsSet; }
+
     private:
         uint8_t m_Buffer[16];
+        bool m_IsSet = false;
 
         friend class ScriptEngine;
-        friend class ScriptInstance;
+        friend class ScriptFieldStorage;
+    };
+
+    // Field values of every entity using one script class. Rows are entities and columns are the class's
+    // fields by index, so copying values into a new instance needs no name lookups
+    class ScriptFieldStorage
+    {
+    public:
+        // Row of the entity with one instance per field, null when nothing was stored for it
+        ScriptFieldInstance* findFields(oak::UUID entityID);
+        // Same, creating a zeroed row when missing
+        ScriptFieldInstance* getFields(oak::UUID entityID);
+
+        // Matches the columns to a (re)loaded class, values are kept for fields with the same name and type
+        void setLayout(const std::vector<ScriptField>& fields);
+
+        uint32_t getFieldCount() const { return (uint32_t)m_Layout.size(); }
+
+    private:
+        struct Column
+        {
+            std::string name;
+            ScriptFieldType type;
+        };
+
+        std::vector<Column> m_Layout;
+        std::unordered_map<oak::UUID, uint32_t> m_Rows;
+        std::vector<ScriptFieldInstance> m_Values; // Row-major, m_Layout.size() per row
     };
 
-    using ScriptFieldMap = std::unordered_map<std::string, ScriptFieldInstance>;
+    // Direct function pointers into managed code from mono_method_get_unmanaged_thunk.
+    // Instance methods take the object first, every thunk reports exceptions through its last parameter
+    using EntityConstructorThunk = void(OAK_MONO_THUNK*)(MonoObject* instance, uint64_t id, uint32_t handle, MonoException** exception);
+    using OnCreateThunk = void(OAK_MONO_THUNK*)(MonoObject* instance, MonoException** exception);
+    using OnUpdateThunk = void(OAK_MONO_THUNK*)(MonoObject* instance, float ts, MonoException** exception);
+    using UpdateBatchThunk = void(OAK_MONO_THUNK*)(MonoObject* batch, MonoArray* entities, int32_t first, int32_t count, float ts, MonoException** exception);
+
+    // Component writes recorded by internal calls while scripts update on worker threads
+    using ScriptCommandBuffer = std::vector<std::function<void()>>;
+
+    // Managed cost of one script class. Times are in milliseconds, everything but instanceCount
+    // is accumulated since the last ScriptEngine::resetStats
+    struct ScriptClassStatistics
+    {
+        std::string className;
+        uint32_t instanceCount = 0;
+        uint32_t onCreateCalls = 0;
+        float onCreateTime = 0.0f;
+        uint32_t onUpdateCalls = 0;
+        float onUpdateTime = 0.0f;
+    };
 
     class ScriptClass
     {
@@ -79,23 +141,43 @@ namespace oak {
         MonoMethod* getMethod(const std::string& name, int parameterCount);
         MonoObject* invokeMethod(MonoObject* instance, MonoMethod* method, void** params = nullptr);
 
-        const std::map<std::string, ScriptField>& getFields() const { return m_Fields; }
+        const std::vector<ScriptField>& getFields() const { return m_Fields; }
+        // Linear search, meant for load time and the serializer
+        const ScriptField* findField(std::string_view name) const;
+        ScriptFieldStorage* getFieldStorage() const { return m_FieldStorage; }
 
     private:
         std::string m_ClassNamespace;
         std::string m_ClassName;
 
-        std::map<std::string, ScriptField> m_Fields;
+        std::vector<ScriptField> m_Fields; // Public fields in declaration order, ScriptField::index is the position
+        ScriptFieldStorage* m_FieldStorage = nullptr;
 
         MonoClass* m_MonoClass = nullptr;
 
+        // Resolved once by loadAssemblyClasses, null when the class does not define the method
+        OnCreateThunk m_OnCreateThunk = nullptr;
+        OnUpdateThunk m_OnUpdateThunk = nullptr;
+
+        // Batched OnUpdate dispatch, see ScriptUpdateBatch.cs. Handles are GC handles, 0 when unset
+        uint32_t m_UpdateBatchHandle = 0;
+        UpdateBatchThunk m_UpdateBatchThunk = nullptr;
+        uint32_t m_InstanceArrayHandle = 0; // Entity[] of the live instances, swap-removed on destroy
+        uint32_t m_InstanceArrayCapacity = 0;
+        std::vector<entt::entity> m_BatchedEntities;
+        bool m_ThreadSafeUpdate = false; // Class has [ThreadSafeUpdate], its batch is split across worker threads
+
+        ScriptClassStatistics m_Stats; // className is filled in by ScriptEngine::getStats
+
         friend class ScriptEngine;
+        friend class ScriptInstance;
     };
 
     class ScriptInstance
     {
     public:
         ScriptInstance(Ref<ScriptClass> scriptClass, oak::Entity entity);
+        ~ScriptInstance();
 
         void invokeOnCreate();
         void invokeOnUpdate(float ts);
@@ -103,42 +185,38 @@ namespace oak {
         Ref<ScriptClass> getScriptClass() { return m_ScriptClass; }
 
         template<typename T>
-        T getFieldValue(const std::string& name)
+        T getFieldValue(const ScriptField& field)
         {
             static_assert(sizeof(T) <= 16, "Type too large!");
 
-            if (!getFieldValueInternal(name, s_FieldValueBuffer)) {
-                return T();
-            }
-
+            getFieldValueInternal(field, s_FieldValueBuffer);
             return *reinterpret_cast<T*>(s_FieldValueBuffer);
         }
 
         template<typename T>
-        void setFieldValue(const std::string& name, T value)
+        void setFieldValue(const ScriptField& field, T value)
         {
             static_assert(sizeof(T) <= 16, "Type too large!");
 
-            setFieldValueInternal(name, &value);
+            setFieldValueInternal(field, &value);
         }
 
-        MonoObject* getManagedObject() { return m_Instance; }
+        // The GC may move the object, so the pointer is only valid until managed code runs again
+        MonoObject* getManagedObject();
 
     private:
-        bool getFieldValueInternal(const std::string& name, void* buffer);
-        bool setFieldValueInternal(const std::string& name, const void* value);
+        void getFieldValueInternal(const ScriptField& field, void* buffer);
+        void setFieldValueInternal(const ScriptField& field, const void* value);
 
         Ref<ScriptClass> m_ScriptClass;
 
-        MonoObject* m_Instance = nullptr;
-        MonoMethod* m_Constructor = nullptr;
-        MonoMethod* m_OnCreateMethod = nullptr;
-        MonoMethod* m_OnUpdateMethod = nullptr;
+        uint32_t m_GCHandle = 0; // Keeps the managed object alive, and tracks it when the GC moves it
+
+        uint32_t m_BatchIndex = 0; // Slot in the class's instance array
 
         inline static char s_FieldValueBuffer[16];
 
         friend class ScriptEngine;
-        friend struct ScriptFieldInstance;
     };
 
     class ScriptEngine
@@ -150,6 +228,7 @@ namespace oak {
         static bool loadAssembly(const std::filesystem::path& filepath);
         static bool loadAppAssembly(const std::filesystem::path& filepath);
 
+        // Opens the assemblies on a worker thread, the domain is swapped on the main thread once they are ready
         static void reloadAssembly();
 
         static void onRuntimeStart(Scene* scene);
@@ -158,19 +237,54 @@ namespace oak {
         static bool entityClassExists(const std::string& fullClassName);
         static void onCreateEntity(oak::Entity entity);
         static void onUpdateEntity(oak::Entity entity, Timestep ts);
+        // Runs OnUpdate of every script instance with one managed call per script class
+        static void onUpdateEntities(Timestep ts);
+        static void onDestroyEntity(oak::Entity entity);
 
         static Scene* getSceneContext();
-        static Ref<ScriptInstance> getEntityScriptInstance(oak::UUID entityID);
+        static Ref<ScriptInstance> getEntityScriptInstance(oak::Entity entity);
 
         static Ref<ScriptClass> getEntityClass(const std::string& name);
         static std::unordered_map<std::string, Ref<ScriptClass>> getEntityClasses();
-        static ScriptFieldMap& getScriptFieldMap(oak::Entity entity);
+        // Field values of the entity's script class, indexed by ScriptField::index. Null when the class does not exist
+        static ScriptFieldInstance* getScriptFields(oak::Entity entity);
+        static ScriptFieldInstance* findScriptFields(oak::Entity entity);
 
         static MonoImage* getCoreAssemblyImage();
 
-        static MonoObject* getManagedInstance(oak::UUID uuid);
+        static MonoObject* getManagedInstance(oak::Entity entity);
 
         static MonoString* createString(const char* string);
+        // Reports a managed exception through the engine log
+        static void logException(MonoObject* exception);
+        // Managed copy of a string owned by `entity`, reused while the text is unchanged so repeated reads
+        // do not allocate. Each entity has one slot, a different string replaces the cached one
+        static MonoString* getCachedString(oak::Entity entity, const std::string& string);
+
+        // Nursery collection, or a collection of every generation when `full`. Only call when no script is running
+        static void collectGarbage(bool full = false);
+        // Called between frames, collects the nursery once ProjectConfig::scriptCollectThreshold bytes were allocated
+        // so collections happen here instead of at an arbitrary allocation inside a script
+        static void onSafePoint();
+
+        // Buffer the calling thread records component writes into, null unless it runs a parallel script update
+        static ScriptCommandBuffer* getCommandBuffer();
+
+        // Stats
+        struct InternalCallStatistics
+        {
+            std::string_view name;
+            uint32_t callCount = 0;
+        };
+
+        struct Statistics
+        {
+            std::vector<ScriptClassStatistics> classes;
+            std::vector<InternalCallStatistics> internalCalls; // Registration order
+            uint32_t gcCollections = 0; // All generations
+        };
+        static void resetStats();
+        static Statistics getStats();
 
     private:
         static void initMono();
@@ -178,6 +292,10 @@ namespace oak {
 
         static MonoObject* instantiateClass(MonoClass* monoClass);
         static void loadAssemblyClasses();
+        static void releaseUpdateBatches();
+        static void releaseCachedStrings();
+        static void swapAssemblies();
+        static void updateBatchParallel(ScriptClass& scriptClass, MonoObject* batch, MonoArray* instances, int32_t count, float ts);
 
         friend class ScriptClass;
         friend class ScriptGlue;
@@ -12,10 +12,13 @@
 #include "Oak/Physics/Physics2D.hpp"
 
 #include "mono/metadata/object.h"
+#include "mono/metadata/appdomain.h"
 #include "mono/metadata/reflection.h"
 
 #include "box2d/b2_body.h"
 
+#include <atomic>
+
 namespace oak {
     namespace utils {
         std::string monoStringToString(MonoString* string)
@@ -30,7 +33,50 @@ namespace oak {
 
     static std::unordered_map<MonoType*, std::function<bool(Entity)>> s_EntityHasComponentFuncs;
 
-#define HZ_ADD_INTERNAL_CALL(Name) mono_add_internal_call("Oak.InternalCalls::" #Name, Name)
+    // Internal calls are registered through a wrapper that counts them for ScriptEngine::getStats
+    static constexpr size_t s_MaxInternalCalls = 128;
+    static std::array<std::atomic<uint32_t>, s_MaxInternalCalls> s_InternalCallCounts;
+    static std::vector<std::string_view> s_InternalCallNames;
+
+    template<auto Function>
+    struct CountedInternalCall;
+
+    template<typename R, typename... Args, R(*Function)(Args...)>
+    struct CountedInternalCall<Function>
+    {
+        inline static size_t slot = 0;
+
+        static R invoke(Args... args)
+        {
+            s_InternalCallCounts[slot].fetch_add(1, std::memory_order_relaxed);
+            return Function(args...);
+        }
+    };
+
+    template<auto Function>
+    static void addInternalCall(const char* managedName, std::string_view name)
+    {
+        OAK_CORE_ASSERT(s_InternalCallNames.size() < s_MaxInternalCalls, "Too many internal calls!");
+
+        CountedInternalCall<Function>::slot = s_InternalCallNames.size();
+        s_InternalCallNames.push_back(name);
+        mono_add_internal_call(managedName, (const void*)&CountedInternalCall<Function>::invoke);
+    }
+
+#define HZ_ADD_INTERNAL_CALL(Name) addInternalCall<Name>("Oak.InternalCalls::" #Name, #Name)
+
+    // Writes made from a parallel script update are queued and applied on the main thread once the batch finishes,
+    // so scripts in the same batch read the state from before the update
+    template<typename Function>
+    static void deferOrRun(Function&& function)
+    {
+        if (auto* commandBuffer = ScriptEngine::getCommandBuffer()) {
+            commandBuffer->emplace_back(std::forward<Function>(function));
+            return;
+        }
+
+        function();
+    }
 
     static void NativeLog(MonoString* string, int parameter)
     {
@@ -50,24 +96,42 @@ namespace oak {
         return glm::dot(*parameter, *parameter);
     }
 
-    static MonoObject* GetScriptInstance(UUID entityID)
+    // Exceptions caught by managed code, e.g. a failing OnUpdate inside a batch
+    static void Log_Exception(MonoObject* exception)
     {
-        return ScriptEngine::getManagedInstance(entityID);
+        ScriptEngine::logException(exception);
     }
 
-    static bool Entity_HasComponent(UUID entityID, MonoReflectionType* componentType)
+    static MonoObject* GetScriptInstance(uint32_t entityHandle)
+    {
+        return ScriptEngine::getManagedInstance({ (entt::entity)entityHandle, ScriptEngine::getSceneContext() });
+    }
+
+    // Managed entities created from a UUID resolve their handle once, later calls index the registry directly
+    static uint32_t Entity_GetHandle(UUID entityID)
     {
         auto* scene = ScriptEngine::getSceneContext();
         OAK_CORE_ASSERT(scene);
         auto entity = scene->getEntityByUUID(entityID);
         OAK_CORE_ASSERT(entity);
 
+        return (uint32_t)entity;
+    }
+
+    static bool Entity_HasComponent(uint32_t entityHandle, MonoReflectionType* componentType)
+    {
+        auto* scene = ScriptEngine::getSceneContext();
+        OAK_CORE_ASSERT(scene);
+        auto entity = scene->getEntityByHandle((entt::entity)entityHandle);
+        OAK_CORE_ASSERT(entity);
+
         MonoType* managedType = mono_reflection_type_get_type(componentType);
         OAK_CORE_ASSERT(s_EntityHasComponentFuncs.find(managedType) != s_EntityHasComponentFuncs.end());
         return s_EntityHasComponentFuncs.at(managedType)(entity);
     }
 
-    static uint64_t Entity_FindEntityByName(MonoString* name)
+    // The handle comes back with the ID so the managed Entity needs no Entity_GetHandle lookup
+    static uint64_t Entity_FindEntityByName(MonoString* name, uint32_t* outHandle)
     {
         char* nameCStr = mono_string_to_utf8(name);
 
@@ -79,119 +143,285 @@ namespace oak {
         if (!entity)
             return 0;
 
+        *outHandle = (uint32_t)entity;
         return entity.getUUID();
     }
 
-    static void TransformComponent_GetTranslation(UUID entityID, glm::vec3* outTranslation)
+    static void TransformComponent_GetTranslation(uint32_t entityHandle, glm::vec3* outTranslation)
     {
         auto* scene = ScriptEngine::getSceneContext();
         OAK_CORE_ASSERT(scene);
-        auto entity = scene->getEntityByUUID(entityID);
+        auto entity = scene->getEntityByHandle((entt::entity)entityHandle);
         OAK_CORE_ASSERT(entity);
 
-        *outTranslation = entity.getComponent<TransformComponent>().translation;
+        *outTranslation = entity.getComponent<TransformComponent>().getTranslation();
     }
 
-    static void TransformComponent_SetTranslation(UUID entityID, glm::vec3* translation)
+    static void TransformComponent_SetTranslation(uint32_t entityHandle, glm::vec3* translation)
     {
         auto* scene = ScriptEngine::getSceneContext();
         OAK_CORE_ASSERT(scene);
-        auto entity = scene->getEntityByUUID(entityID);
+        auto entity = scene->getEntityByHandle((entt::entity)entityHandle);
         OAK_CORE_ASSERT(entity);
 
-        entity.getComponent<TransformComponent>().translation = *translation;
+        deferOrRun([entity, translation = *translation]() mutable {
+            entity.getComponent<TransformComponent>().setTranslation(translation);
+        });
     }
 
-    static void Rigidbody2DComponent_ApplyLinearImpulse(UUID entityID, glm::vec2* impulse, glm::vec2* point, bool wake)
+    // Bulk calls read and write blittable managed arrays in place, one native transition per group of entities.
+    // Nothing here allocates managed memory, so the GC cannot move the arrays during the call
+    static void TransformComponent_GetTranslations(MonoArray* entityHandles, MonoArray* outTranslations)
     {
         auto* scene = ScriptEngine::getSceneContext();
         OAK_CORE_ASSERT(scene);
-        auto entity = scene->getEntityByUUID(entityID);
+        OAK_CORE_ASSERT(mono_array_length(outTranslations) >= mono_array_length(entityHandles));
+
+        const auto count = mono_array_length(entityHandles);
+        auto* handles = mono_array_addr(entityHandles, uint32_t, 0);
+        auto* translations = mono_array_addr(outTranslations, glm::vec3, 0);
+        for (uintptr_t i = 0; i < count; i++) {
+            auto entity = scene->getEntityByHandle((entt::entity)handles[i]);
+            OAK_CORE_ASSERT(entity);
+
+            translations[i] = entity.getComponent<TransformComponent>().getTranslation();
+        }
+    }
+
+    static void TransformComponent_SetTranslations(MonoArray* entityHandles, MonoArray* translations)
+    {
+        auto* scene = ScriptEngine::getSceneContext();
+        OAK_CORE_ASSERT(scene);
+        OAK_CORE_ASSERT(mono_array_length(translations) >= mono_array_length(entityHandles));
+
+        const auto count = mono_array_length(entityHandles);
+        auto* handles = mono_array_addr(entityHandles, uint32_t, 0);
+        auto* values = mono_array_addr(translations, glm::vec3, 0);
+        if (ScriptEngine::getCommandBuffer()) {
+            deferOrRun([scene, handles = std::vector<uint32_t>(handles, handles + count), values = std::vector<glm::vec3>(values, values + count)]() {
+                for (size_t i = 0; i < handles.size(); i++) {
+                    scene->getEntityByHandle((entt::entity)handles[i]).getComponent<TransformComponent>().setTranslation(values[i]);
+                }
+            });
+            return;
+        }
+
+        for (uintptr_t i = 0; i < count; i++) {
+            auto entity = scene->getEntityByHandle((entt::entity)handles[i]);
+            OAK_CORE_ASSERT(entity);
+
+            entity.getComponent<TransformComponent>().setTranslation(values[i]);
+        }
+    }
+
+    // Returns the IDs and hands back the matching registry handles, so managed code needs no lookup per entity
+    static MonoArray* makeEntityIDArray(std::vector<Entity>& entities, MonoArray** outHandles)
+    {
+        auto* domain = mono_domain_get();
+        auto* ids = mono_array_new(domain, mono_get_uint64_class(), entities.size());
+        auto* handles = mono_array_new(domain, mono_get_uint32_class(), entities.size());
+        for (size_t i = 0; i < entities.size(); i++) {
+            mono_array_set(ids, uint64_t, i, (uint64_t)entities[i].getUUID());
+            mono_array_set(handles, uint32_t, i, (uint32_t)entities[i]);
+        }
+
+        *outHandles = handles;
+        return ids;
+    }
+
+    static MonoArray* Scene_QueryRegion(glm::vec2* min, glm::vec2* max, MonoArray** outHandles)
+    {
+        auto* scene = ScriptEngine::getSceneContext();
+        OAK_CORE_ASSERT(scene);
+
+        auto entities = scene->queryRegion(*min, *max);
+        return makeEntityIDArray(entities, outHandles);
+    }
+
+    static MonoArray* Scene_QueryPoint(glm::vec2* point, MonoArray** outHandles)
+    {
+        auto* scene = ScriptEngine::getSceneContext();
+        OAK_CORE_ASSERT(scene);
+
+        auto entities = scene->queryPoint(*point);
+        return makeEntityIDArray(entities, outHandles);
+    }
+
+    // Managed arrays of blittable structs viewed in place
+    template<typename T>
+    static std::span<T> arraySpan(MonoArray* array)
+    {
+        return { mono_array_addr(array, T, 0), mono_array_length(array) };
+    }
+
+    // Matches Oak.RaycastHit2D, which is filled in place
+    static_assert(sizeof(RaycastHit2D) == 32 && offsetof(RaycastHit2D, fraction) == 24);
+
+    static void Physics2D_Raycast(MonoArray* starts, MonoArray* ends, MonoArray* outHits)
+    {
+        auto* scene = ScriptEngine::getSceneContext();
+        OAK_CORE_ASSERT(scene);
+
+        scene->raycast2D(arraySpan<const glm::vec2>(starts), arraySpan<const glm::vec2>(ends), arraySpan<RaycastHit2D>(outHits));
+    }
+
+    static int32_t Physics2D_OverlapBoxes(MonoArray* mins, MonoArray* maxs, MonoArray* outEntityIDs, MonoArray* outCounts)
+    {
+        auto* scene = ScriptEngine::getSceneContext();
+        OAK_CORE_ASSERT(scene);
+
+        return (int32_t)scene->overlapBox2D(arraySpan<const glm::vec2>(mins), arraySpan<const glm::vec2>(maxs), arraySpan<UUID>(outEntityIDs), arraySpan<uint32_t>(outCounts));
+    }
+
+    static int32_t Physics2D_QueryPoints(MonoArray* points, MonoArray* outEntityIDs, MonoArray* outCounts)
+    {
+        auto* scene = ScriptEngine::getSceneContext();
+        OAK_CORE_ASSERT(scene);
+
+        return (int32_t)scene->queryPoint2D(arraySpan<const glm::vec2>(points), arraySpan<UUID>(outEntityIDs), arraySpan<uint32_t>(outCounts));
+    }
+
+    // Bodies of a scene that just started may still wait for their creation budget.
+    // Reads fall back to the component, writes create the body once they run on the main thread
+    static b2Body* findBody(Entity entity)
+    {
+        return (b2Body*)entity.getComponent<Rigidbody2DComponent>().runtimeBody;
+    }
+
+    static void Rigidbody2DComponent_ApplyLinearImpulse(uint32_t entityHandle, glm::vec2* impulse, glm::vec2* point, bool wake)
+    {
+        auto* scene = ScriptEngine::getSceneContext();
+        OAK_CORE_ASSERT(scene);
+        auto entity = scene->getEntityByHandle((entt::entity)entityHandle);
         OAK_CORE_ASSERT(entity);
 
-        auto& rb2d = entity.getComponent<Rigidbody2DComponent>();
-        b2Body* body = (b2Body*)rb2d.runtimeBody;
-        body->ApplyLinearImpulse(b2Vec2(impulse->x, impulse->y), b2Vec2(point->x, point->y), wake);
+        deferOrRun([scene, entity, impulse = b2Vec2(impulse->x, impulse->y), point = b2Vec2(point->x, point->y), wake]() {
+            scene->getPhysics2DBody(entity)->ApplyLinearImpulse(impulse, point, wake);
+        });
     }
 
-    static void Rigidbody2DComponent_ApplyLinearImpulseToCenter(UUID entityID, glm::vec2* impulse, bool wake)
+    static void Rigidbody2DComponent_ApplyLinearImpulseToCenter(uint32_t entityHandle, glm::vec2* impulse, bool wake)
     {
         auto* scene = ScriptEngine::getSceneContext();
         OAK_CORE_ASSERT(scene);
-        auto entity = scene->getEntityByUUID(entityID);
+        auto entity = scene->getEntityByHandle((entt::entity)entityHandle);
         OAK_CORE_ASSERT(entity);
 
-        auto& rb2d = entity.getComponent<Rigidbody2DComponent>();
-        b2Body* body = (b2Body*)rb2d.runtimeBody;
-        body->ApplyLinearImpulseToCenter(b2Vec2(impulse->x, impulse->y), wake);
+        deferOrRun([scene, entity, impulse = b2Vec2(impulse->x, impulse->y), wake]() {
+            scene->getPhysics2DBody(entity)->ApplyLinearImpulseToCenter(impulse, wake);
+        });
     }
 
-    static void Rigidbody2DComponent_GetLinearVelocity(UUID entityID, glm::vec2* outLinearVelocity)
+    static void Rigidbody2DComponent_GetLinearVelocity(uint32_t entityHandle, glm::vec2* outLinearVelocity)
     {
         auto* scene = ScriptEngine::getSceneContext();
         OAK_CORE_ASSERT(scene);
-        auto entity = scene->getEntityByUUID(entityID);
+        auto entity = scene->getEntityByHandle((entt::entity)entityHandle);
         OAK_CORE_ASSERT(entity);
 
-        auto& rb2d = entity.getComponent<Rigidbody2DComponent>();
-        b2Body* body = (b2Body*)rb2d.runtimeBody;
-        const b2Vec2& linearVelocity = body->GetLinearVelocity();
-        *outLinearVelocity = glm::vec2(linearVelocity.x, linearVelocity.y);
+        const auto* body = findBody(entity);
+        *outLinearVelocity = body ? glm::vec2(body->GetLinearVelocity().x, body->GetLinearVelocity().y) : glm::vec2(0.0f);
     }
 
-    static Rigidbody2DComponent::BodyType Rigidbody2DComponent_GetType(UUID entityID)
+    static void Rigidbody2DComponent_GetLinearVelocities(MonoArray* entityHandles, MonoArray* outLinearVelocities)
     {
         auto* scene = ScriptEngine::getSceneContext();
         OAK_CORE_ASSERT(scene);
-        auto entity = scene->getEntityByUUID(entityID);
+        OAK_CORE_ASSERT(mono_array_length(outLinearVelocities) >= mono_array_length(entityHandles));
+
+        const auto count = mono_array_length(entityHandles);
+        auto* handles = mono_array_addr(entityHandles, uint32_t, 0);
+        auto* velocities = mono_array_addr(outLinearVelocities, glm::vec2, 0);
+        for (uintptr_t i = 0; i < count; i++) {
+            auto entity = scene->getEntityByHandle((entt::entity)handles[i]);
+            OAK_CORE_ASSERT(entity);
+
+            const auto* body = findBody(entity);
+            velocities[i] = body ? glm::vec2(body->GetLinearVelocity().x, body->GetLinearVelocity().y) : glm::vec2(0.0f);
+        }
+    }
+
+    static void Rigidbody2DComponent_SetLinearVelocities(MonoArray* entityHandles, MonoArray* linearVelocities)
+    {
+        auto* scene = ScriptEngine::getSceneContext();
+        OAK_CORE_ASSERT(scene);
+        OAK_CORE_ASSERT(mono_array_length(linearVelocities) >= mono_array_length(entityHandles));
+
+        const auto count = mono_array_length(entityHandles);
+        auto* handles = mono_array_addr(entityHandles, uint32_t, 0);
+        auto* velocities = mono_array_addr(linearVelocities, glm::vec2, 0);
+        if (ScriptEngine::getCommandBuffer()) {
+            deferOrRun([scene, handles = std::vector<uint32_t>(handles, handles + count), velocities = std::vector<glm::vec2>(velocities, velocities + count)]() {
+                for (size_t i = 0; i < handles.size(); i++) {
+                    b2Body* body = scene->getPhysics2DBody((entt::entity)handles[i]);
+                    body->SetLinearVelocity(b2Vec2(velocities[i].x, velocities[i].y));
+                }
+            });
+            return;
+        }
+
+        for (uintptr_t i = 0; i < count; i++) {
+            auto entity = scene->getEntityByHandle((entt::entity)handles[i]);
+            OAK_CORE_ASSERT(entity);
+
+            b2Body* body = scene->getPhysics2DBody(entity);
+            body->SetLinearVelocity(b2Vec2(velocities[i].x, velocities[i].y));
+        }
+    }
+
+    static Rigidbody2DComponent::BodyType Rigidbody2DComponent_GetType(uint32_t entityHandle)
+    {
+        auto* scene = ScriptEngine::getSceneContext();
+        OAK_CORE_ASSERT(scene);
+        auto entity = scene->getEntityByHandle((entt::entity)entityHandle);
         OAK_CORE_ASSERT(entity);
 
-        auto& rb2d = entity.getComponent<Rigidbody2DComponent>();
-        b2Body* body = (b2Body*)rb2d.runtimeBody;
-        return utils::rigidbody2DTypeFromBox2DBody(body->GetType());
+        const auto* body = findBody(entity);
+        return body ? utils::rigidbody2DTypeFromBox2DBody(body->GetType()) : entity.getComponent<Rigidbody2DComponent>().type;
     }
 
-    static void Rigidbody2DComponent_SetType(UUID entityID, Rigidbody2DComponent::BodyType bodyType)
+    static void Rigidbody2DComponent_SetType(uint32_t entityHandle, Rigidbody2DComponent::BodyType bodyType)
     {
         auto* scene = ScriptEngine::getSceneContext();
         OAK_CORE_ASSERT(scene);
-        auto entity = scene->getEntityByUUID(entityID);
+        auto entity = scene->getEntityByHandle((entt::entity)entityHandle);
         OAK_CORE_ASSERT(entity);
 
-        auto& rb2d = entity.getComponent<Rigidbody2DComponent>();
-        b2Body* body = (b2Body*)rb2d.runtimeBody;
-        body->SetType(utils::rigidbody2DTypeToBox2DBody(bodyType));
+        deferOrRun([scene, entity, bodyType]() {
+            scene->getPhysics2DBody(entity)->SetType(utils::rigidbody2DTypeToBox2DBody(bodyType));
+        });
     }
 
-    static MonoString* TextComponent_GetText(UUID entityID)
+    static MonoString* TextComponent_GetText(uint32_t entityHandle)
     {
         auto* scene = ScriptEngine::getSceneContext();
         OAK_CORE_ASSERT(scene);
-        auto entity = scene->getEntityByUUID(entityID);
+        auto entity = scene->getEntityByHandle((entt::entity)entityHandle);
         OAK_CORE_ASSERT(entity);
         OAK_CORE_ASSERT(entity.hasComponent<TextComponent>());
 
         auto& tc = entity.getComponent<TextComponent>();
-        return ScriptEngine::createString(tc.textString.c_str());
+        return ScriptEngine::getCachedString(entity, tc.textString);
     }
 
-    static void TextComponent_SetText(UUID entityID, MonoString* textString)
+    static void TextComponent_SetText(uint32_t entityHandle, MonoString* textString)
     {
         auto* scene = ScriptEngine::getSceneContext();
         OAK_CORE_ASSERT(scene);
-        auto entity = scene->getEntityByUUID(entityID);
+        auto entity = scene->getEntityByHandle((entt::entity)entityHandle);
         OAK_CORE_ASSERT(entity);
         OAK_CORE_ASSERT(entity.hasComponent<TextComponent>());
 
-        auto& tc = entity.getComponent<TextComponent>();
-        tc.textString = utils::monoStringToString(textString);
+        deferOrRun([entity, text = utils::monoStringToString(textString)]() mutable {
+            entity.patchComponent<TextComponent>([&](auto& tc) { tc.textString = std::move(text); });
+        });
     }
 
-    static void TextComponent_GetColor(UUID entityID, glm::vec4* color)
+    static void TextComponent_GetColor(uint32_t entityHandle, glm::vec4* color)
     {
         auto* scene = ScriptEngine::getSceneContext();
         OAK_CORE_ASSERT(scene);
-        auto entity = scene->getEntityByUUID(entityID);
+        auto entity = scene->getEntityByHandle((entt::entity)entityHandle);
         OAK_CORE_ASSERT(entity);
         OAK_CORE_ASSERT(entity.hasComponent<TextComponent>());
 
@@ -199,23 +429,24 @@ namespace oak {
         *color = tc.color;
     }
 
-    static void TextComponent_SetColor(UUID entityID, glm::vec4* color)
+    static void TextComponent_SetColor(uint32_t entityHandle, glm::vec4* color)
     {
         auto* scene = ScriptEngine::getSceneContext();
         OAK_CORE_ASSERT(scene);
-        auto entity = scene->getEntityByUUID(entityID);
+        auto entity = scene->getEntityByHandle((entt::entity)entityHandle);
         OAK_CORE_ASSERT(entity);
         OAK_CORE_ASSERT(entity.hasComponent<TextComponent>());
 
-        auto& tc = entity.getComponent<TextComponent>();
-        tc.color = *color;
+        deferOrRun([entity, color = *color]() mutable {
+            entity.getComponent<TextComponent>().color = color;
+        });
     }
 
-    static float TextComponent_GetKerning(UUID entityID)
+    static float TextComponent_GetKerning(uint32_t entityHandle)
     {
         auto* scene = ScriptEngine::getSceneContext();
         OAK_CORE_ASSERT(scene);
-        auto entity = scene->getEntityByUUID(entityID);
+        auto entity = scene->getEntityByHandle((entt::entity)entityHandle);
         OAK_CORE_ASSERT(entity);
         OAK_CORE_ASSERT(entity.hasComponent<TextComponent>());
 
@@ -223,23 +454,24 @@ namespace oak {
         return tc.kerning;
     }
 
-    static void TextComponent_SetKerning(UUID entityID, float kerning)
+    static void TextComponent_SetKerning(uint32_t entityHandle, float kerning)
     {
         auto* scene = ScriptEngine::getSceneContext();
         OAK_CORE_ASSERT(scene);
-        auto entity = scene->getEntityByUUID(entityID);
+        auto entity = scene->getEntityByHandle((entt::entity)entityHandle);
         OAK_CORE_ASSERT(entity);
         OAK_CORE_ASSERT(entity.hasComponent<TextComponent>());
 
-        auto& tc = entity.getComponent<TextComponent>();
-        tc.kerning = kerning;
+        deferOrRun([entity, kerning]() mutable {
+            entity.patchComponent<TextComponent>([&](auto& tc) { tc.kerning = kerning; });
+        });
     }
 
-    static float TextComponent_GetLineSpacing(UUID entityID)
+    static float TextComponent_GetLineSpacing(uint32_t entityHandle)
     {
         auto* scene = ScriptEngine::getSceneContext();
         OAK_CORE_ASSERT(scene);
-        auto entity = scene->getEntityByUUID(entityID);
+        auto entity = scene->getEntityByHandle((entt::entity)entityHandle);
         OAK_CORE_ASSERT(entity);
         OAK_CORE_ASSERT(entity.hasComponent<TextComponent>());
 
@@ -247,16 +479,17 @@ namespace oak {
         return tc.lineSpacing;
     }
 
-    static void TextComponent_SetLineSpacing(UUID entityID, float lineSpacing)
+    static void TextComponent_SetLineSpacing(uint32_t entityHandle, float lineSpacing)
     {
         auto* scene = ScriptEngine::getSceneContext();
         OAK_CORE_ASSERT(scene);
-        auto entity = scene->getEntityByUUID(entityID);
+        auto entity = scene->getEntityByHandle((entt::entity)entityHandle);
         OAK_CORE_ASSERT(entity);
         OAK_CORE_ASSERT(entity.hasComponent<TextComponent>());
 
-        auto& tc = entity.getComponent<TextComponent>();
-        tc.lineSpacing = lineSpacing;
+        deferOrRun([entity, lineSpacing]() mutable {
+            entity.patchComponent<TextComponent>([&](auto& tc) { tc.lineSpacing = lineSpacing; });
+        });
     }
 
     static bool Input_IsKeyDown(KeyCode keycode)
@@ -294,23 +527,53 @@ namespace oak {
         RegisterComponent(AllComponents{});
     }
 
+    void ScriptGlue::getInternalCallStatistics(std::vector<ScriptEngine::InternalCallStatistics>& outStatistics)
+    {
+        outStatistics.clear();
+        for (size_t i = 0; i < s_InternalCallNames.size(); i++) {
+            outStatistics.push_back({ s_InternalCallNames[i], s_InternalCallCounts[i].load(std::memory_order_relaxed) });
+        }
+    }
+
+    void ScriptGlue::resetInternalCallStatistics()
+    {
+        for (auto& count : s_InternalCallCounts) {
+            count.store(0, std::memory_order_relaxed);
+        }
+    }
+
     void ScriptGlue::registerFunctions()
     {
+        s_InternalCallNames.clear();
+
         HZ_ADD_INTERNAL_CALL(NativeLog);
         HZ_ADD_INTERNAL_CALL(NativeLog_Vector);
         HZ_ADD_INTERNAL_CALL(NativeLog_VectorDot);
+        HZ_ADD_INTERNAL_CALL(Log_Exception);
 
         HZ_ADD_INTERNAL_CALL(GetScriptInstance);
 
+        HZ_ADD_INTERNAL_CALL(Entity_GetHandle);
         HZ_ADD_INTERNAL_CALL(Entity_HasComponent);
         HZ_ADD_INTERNAL_CALL(Entity_FindEntityByName);
 
         HZ_ADD_INTERNAL_CALL(TransformComponent_GetTranslation);
         HZ_ADD_INTERNAL_CALL(TransformComponent_SetTranslation);
+        HZ_ADD_INTERNAL_CALL(TransformComponent_GetTranslations);
+        HZ_ADD_INTERNAL_CALL(TransformComponent_SetTranslations);
+
+        HZ_ADD_INTERNAL_CALL(Scene_QueryRegion);
+        HZ_ADD_INTERNAL_CALL(Scene_QueryPoint);
+
+        HZ_ADD_INTERNAL_CALL(Physics2D_Raycast);
+        HZ_ADD_INTERNAL_CALL(Physics2D_OverlapBoxes);
+        HZ_ADD_INTERNAL_CALL(Physics2D_QueryPoints);
 
         HZ_ADD_INTERNAL_CALL(Rigidbody2DComponent_ApplyLinearImpulse);
         HZ_ADD_INTERNAL_CALL(Rigidbody2DComponent_ApplyLinearImpulseToCenter);
         HZ_ADD_INTERNAL_CALL(Rigidbody2DComponent_GetLinearVelocity);
+        HZ_ADD_INTERNAL_CALL(Rigidbody2DComponent_GetLinearVelocities);
+        HZ_ADD_INTERNAL_CALL(Rigidbody2DComponent_SetLinearVelocities);
         HZ_ADD_INTERNAL_CALL(Rigidbody2DComponent_GetType);
         HZ_ADD_INTERNAL_CALL(Rigidbody2DComponent_SetType);
 
@@ -1,10 +1,16 @@
 #pragma once
 
+#include "ScriptEngine.hpp"
+
 namespace oak {
     class ScriptGlue
     {
     public:
         static void registerComponents();
         static void registerFunctions();
+
+        // Calls made through each internal call since the last reset
+        static void getInternalCallStatistics(std::vector<ScriptEngine::InternalCallStatistics>& outStatistics);
+        static void resetInternalCallStatistics();
     };
 }
@@ -27,10 +27,46 @@ namespace opengl {
         glBufferData(GL_ARRAY_BUFFER, t_indicies.size(), t_indicies.data(), GL_STATIC_DRAW);
     }
 
+    VertexBuffer::VertexBuffer(uint32_t t_batchSize, uint32_t t_framesInFlight, uint32_t t_batchesPerFrame)
+        : m_BatchSize(t_batchSize), m_RegionSize(t_batchSize * t_batchesPerFrame), m_Fences(t_framesInFlight, nullptr)
+    {
+        OAK_PROFILE_FUNCTION();
+
+        if (t_framesInFlight == 0) {
+            throw std::invalid_argument("Streaming vertex buffer needs at least one frame in flight!");
+        }
+        if (t_batchesPerFrame == 0) {
+            throw std::invalid_argument("Streaming vertex buffer needs room for at least one batch per frame!");
+        }
+
+        // Coherent persistent mapping: writes become visible to the GPU without explicit flushes,
+        // synchronization is done per region with fences instead of implicit driver stalls.
+        constexpr GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+        const auto totalSize = static_cast<GLsizeiptr>(m_RegionSize) * t_framesInFlight;
+
+        glCreateBuffers(1, &m_RendererID);
+        glNamedBufferStorage(m_RendererID, totalSize, nullptr, flags);
+        m_MappedData = static_cast<std::byte*>(glMapNamedBufferRange(m_RendererID, 0, totalSize, flags));
+
+        if (!m_MappedData) {
+            throw std::runtime_error("Failed to persistently map streaming vertex buffer!");
+        }
+    }
+
     VertexBuffer::~VertexBuffer()
     {
         OAK_PROFILE_FUNCTION();
 
+        for (auto fence : m_Fences) {
+            if (fence) {
+                glDeleteSync(fence);
+            }
+        }
+
+        if (m_MappedData) {
+            glUnmapNamedBuffer(m_RendererID);
+        }
+
         glDeleteBuffers(1, &m_RendererID);
     }
 
@@ -50,10 +86,87 @@ namespace opengl {
 
     constexpr auto VertexBuffer::setData(std::span<std::byte> t_indicies) -> void
     {
+        if (m_MappedData) {
+            auto region = map();
+            std::memcpy(region.data(), t_indicies.data(), std::min(region.size(), t_indicies.size()));
+            return;
+        }
+
         glBindBuffer(GL_ARRAY_BUFFER, m_RendererID);
         glBufferSubData(GL_ARRAY_BUFFER, 0, t_indicies.size(), t_indicies.data());
     }
 
+    constexpr auto VertexBuffer::map() -> std::span<std::byte>
+    {
+        if (!m_MappedData) {
+            return {};
+        }
+
+        // Not enough room left for a whole batch, the rest of the frame continues in the next region
+        if (m_RegionOffset + m_BatchSize > m_RegionSize) {
+            endFrame();
+        }
+
+        waitForRegion(m_RegionIndex);
+        return { m_MappedData + static_cast<size_t>(m_RegionIndex) * m_RegionSize + m_RegionOffset, m_BatchSize };
+    }
+
+    constexpr auto VertexBuffer::commit(uint32_t t_size) -> void
+    {
+        if (!m_MappedData) {
+            return;
+        }
+
+        OAK_CORE_ASSERT(t_size <= m_BatchSize, "Committed more than one batch!");
+        m_RegionOffset += t_size;
+    }
+
+    constexpr auto VertexBuffer::endFrame() -> void
+    {
+        // A region nothing was written to has no draw calls to wait for
+        if (!m_MappedData || m_RegionOffset == 0) {
+            return;
+        }
+
+        m_Fences[m_RegionIndex] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+        m_RegionIndex = (m_RegionIndex + 1) % static_cast<uint32_t>(m_Fences.size());
+        m_RegionOffset = 0;
+    }
+
+    constexpr auto VertexBuffer::getBaseVertex() const -> uint32_t
+    {
+        if (!m_MappedData || m_Layout.getStride() == 0) {
+            return 0;
+        }
+
+        return (m_RegionIndex * m_RegionSize + m_RegionOffset) / m_Layout.getStride();
+    }
+
+    auto VertexBuffer::waitForRegion(uint32_t t_region) -> void
+    {
+        auto& fence = m_Fences[t_region];
+        if (!fence) {
+            return;
+        }
+
+        OAK_PROFILE_FUNCTION();
+
+        constexpr GLuint64 timeout = 1'000'000; // 1 ms
+        GLbitfield waitFlags = 0;
+        while (true) {
+            const auto result = glClientWaitSync(fence, waitFlags, timeout);
+            if (result == GL_ALREADY_SIGNALED || result == GL_CONDITION_SATISFIED || result == GL_WAIT_FAILED) {
+                break;
+            }
+
+            // Make sure the fence actually gets submitted before waiting again
+            waitFlags = GL_SYNC_FLUSH_COMMANDS_BIT;
+        }
+
+        glDeleteSync(fence);
+        fence = nullptr;
+    }
+
     /////////////////////////////////////////////////////////////////////////////
     // IndexBuffer //////////////////////////////////////////////////////////////
     /////////////////////////////////////////////////////////////////////////////
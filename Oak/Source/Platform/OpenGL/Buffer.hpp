@@ -2,12 +2,15 @@
 
 #include "Oak/Renderer/Buffer.hpp"
 
+#include <glad/gl.h>
+
 namespace opengl {
     class VertexBuffer final : public oak::VertexBuffer
     {
     public:
         VertexBuffer(uint32_t t_size);
         VertexBuffer(std::span<float> t_indicies);
+        VertexBuffer(uint32_t t_batchSize, uint32_t t_framesInFlight, uint32_t t_batchesPerFrame);
         ~VertexBuffer() override;
 
         constexpr auto bind() -> void const override;
@@ -15,6 +18,11 @@ namespace opengl {
 
         constexpr auto setData(std::span<std::byte> t_indicies) -> void override;
 
+        constexpr auto map() -> std::span<std::byte> override;
+        constexpr auto commit(uint32_t t_size) -> void override;
+        constexpr auto endFrame() -> void override;
+        constexpr auto getBaseVertex() const -> uint32_t override;
+
         constexpr auto getLayout() const -> const oak::BufferLayout& override
         {
             return m_Layout;
@@ -26,8 +34,18 @@ namespace opengl {
         }
 
     private:
+        auto waitForRegion(uint32_t t_region) -> void;
+
         uint32_t m_RendererID{};
         oak::BufferLayout m_Layout{};
+
+        // Streaming mode
+        std::byte* m_MappedData{ nullptr };
+        uint32_t m_BatchSize{};
+        uint32_t m_RegionSize{};
+        uint32_t m_RegionIndex{};
+        uint32_t m_RegionOffset{}; // Write cursor within the current region
+        std::vector<GLsync> m_Fences{};
     };
 
     class IndexBuffer final : public oak::IndexBuffer
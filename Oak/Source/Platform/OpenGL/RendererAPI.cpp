@@ -68,17 +68,28 @@ namespace opengl {
         glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
     }
 
-    void RendererAPI::drawIndexed(const oak::Ref<oak::VertexArray>& t_vertexArray, uint32_t t_indexCount)
+    void RendererAPI::drawIndexed(const oak::Ref<oak::VertexArray>& t_vertexArray, uint32_t t_indexCount, uint32_t t_baseVertex)
     {
         t_vertexArray->bind();
         auto count = t_indexCount ? t_indexCount : t_vertexArray->getIndexBuffer()->getCount();
-        glDrawElements(GL_TRIANGLES, count, GL_UNSIGNED_INT, nullptr);
+        if (t_baseVertex) {
+            glDrawElementsBaseVertex(GL_TRIANGLES, count, GL_UNSIGNED_INT, nullptr, t_baseVertex);
+        }
+        else {
+            glDrawElements(GL_TRIANGLES, count, GL_UNSIGNED_INT, nullptr);
+        }
+    }
+
+    void RendererAPI::drawIndexedInstanced(const oak::Ref<oak::VertexArray>& t_vertexArray, uint32_t t_indexCount, uint32_t t_instanceCount, uint32_t t_baseInstance)
+    {
+        t_vertexArray->bind();
+        glDrawElementsInstancedBaseVertexBaseInstance(GL_TRIANGLES, t_indexCount, GL_UNSIGNED_INT, nullptr, t_instanceCount, 0, t_baseInstance);
     }
 
-    void RendererAPI::drawLines(const oak::Ref<oak::VertexArray>& t_vertexArray, uint32_t t_vertexCount)
+    void RendererAPI::drawLines(const oak::Ref<oak::VertexArray>& t_vertexArray, uint32_t t_vertexCount, uint32_t t_firstVertex)
     {
         t_vertexArray->bind();
-        glDrawArrays(GL_LINES, 0, t_vertexCount);
+        glDrawArrays(GL_LINES, t_firstVertex, t_vertexCount);
     }
 
     void RendererAPI::setLineWidth(float t_width)
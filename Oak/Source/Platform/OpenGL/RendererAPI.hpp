@@ -12,8 +12,9 @@ namespace opengl {
         void setClearColor(const glm::vec4& t_color) override;
         void clear() override;
 
-        void drawIndexed(const oak::Ref<oak::VertexArray>& t_vertexArray, uint32_t t_indexCount = 0) override;
-        void drawLines(const oak::Ref<oak::VertexArray>& t_vertexArray, uint32_t t_vertexCount) override;
+        void drawIndexed(const oak::Ref<oak::VertexArray>& t_vertexArray, uint32_t t_indexCount = 0, uint32_t t_baseVertex = 0) override;
+        void drawIndexedInstanced(const oak::Ref<oak::VertexArray>& t_vertexArray, uint32_t t_indexCount, uint32_t t_instanceCount, uint32_t t_baseInstance = 0) override;
+        void drawLines(const oak::Ref<oak::VertexArray>& t_vertexArray, uint32_t t_vertexCount, uint32_t t_firstVertex = 0) override;
 
         void setLineWidth(float width) override;
     };
@@ -79,6 +79,11 @@ namespace opengl {
             m_InternalFormat = internalFormat;
             m_DataFormat = dataFormat;
 
+            m_Specification.width = m_Resolution.first;
+            m_Specification.height = m_Resolution.second;
+            m_Specification.format = channels == 4 ? oak::ImageFormat::RGBA8 : oak::ImageFormat::RGB8;
+            m_Specification.generateMips = false;
+
             OAK_CORE_ASSERT(internalFormat & dataFormat, "Format not supported!");
 
             glCreateTextures(GL_TEXTURE_2D, 1, &m_RendererID);
@@ -116,10 +121,70 @@ namespace opengl {
         glTextureSubImage2D(m_RendererID, 0, 0, 0, width, height, m_DataFormat, GL_UNSIGNED_BYTE, data);
     }
 
+    void Texture2D::copyRegion(const oak::Texture& source, uint32_t sourceX, uint32_t sourceY, uint32_t x, uint32_t y, uint32_t width, uint32_t height)
+    {
+        OAK_PROFILE_FUNCTION();
+
+        glCopyImageSubData(source.getRendererID(), GL_TEXTURE_2D, 0, sourceX, sourceY, 0,
+            m_RendererID, GL_TEXTURE_2D, 0, x, y, 0,
+            width, height, 1);
+    }
+
     void Texture2D::bind(uint32_t slot) const
     {
         OAK_PROFILE_FUNCTION();
 
         glBindTextureUnit(slot, m_RendererID);
     }
+
+    Texture2DArray::Texture2DArray(const oak::TextureSpecification& specification, uint32_t layerCount) : m_Specification{ specification }, m_LayerCount{ layerCount }
+    {
+        OAK_PROFILE_FUNCTION();
+
+        glCreateTextures(GL_TEXTURE_2D_ARRAY, 1, &m_RendererID);
+        glTextureStorage3D(m_RendererID, 1, utils::oakImageFormatToGLInternalFormat(specification.format), specification.width, specification.height, layerCount);
+
+        glTextureParameteri(m_RendererID, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+        glTextureParameteri(m_RendererID, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+
+        glTextureParameteri(m_RendererID, GL_TEXTURE_WRAP_S, GL_REPEAT);
+        glTextureParameteri(m_RendererID, GL_TEXTURE_WRAP_T, GL_REPEAT);
+    }
+
+    Texture2DArray::~Texture2DArray()
+    {
+        OAK_PROFILE_FUNCTION();
+
+        glDeleteTextures(1, &m_RendererID);
+    }
+
+    void Texture2DArray::copyToLayer(uint32_t layer, const oak::Texture2D& texture)
+    {
+        OAK_PROFILE_FUNCTION();
+
+        OAK_CORE_ASSERT(layer < m_LayerCount, "Texture array layer out of range!");
+        OAK_CORE_ASSERT(texture.getWidth() == m_Specification.width && texture.getHeight() == m_Specification.height, "Texture does not match the array size!");
+
+        glCopyImageSubData(texture.getRendererID(), GL_TEXTURE_2D, 0, 0, 0, 0,
+            m_RendererID, GL_TEXTURE_2D_ARRAY, 0, 0, 0, layer,
+            m_Specification.width, m_Specification.height, 1);
+    }
+
+    void Texture2DArray::copyLayers(const oak::Texture2DArray& source, uint32_t count)
+    {
+        OAK_PROFILE_FUNCTION();
+
+        OAK_CORE_ASSERT(count <= m_LayerCount && count <= source.getLayerCount(), "Texture array layer out of range!");
+
+        glCopyImageSubData(source.getRendererID(), GL_TEXTURE_2D_ARRAY, 0, 0, 0, 0,
+            m_RendererID, GL_TEXTURE_2D_ARRAY, 0, 0, 0, 0,
+            m_Specification.width, m_Specification.height, count);
+    }
+
+    void Texture2DArray::bind(uint32_t slot) const
+    {
+        OAK_PROFILE_FUNCTION();
+
+        glBindTextureUnit(slot, m_RendererID);
+    }
 }
@@ -38,6 +38,7 @@ namespace opengl {
         }
         
         void setData(void* data, uint32_t size) override;
+        void copyRegion(const oak::Texture& source, uint32_t sourceX, uint32_t sourceY, uint32_t x, uint32_t y, uint32_t width, uint32_t height) override;
 
         void bind(uint32_t slot = 0) const override;
 
@@ -57,4 +58,37 @@ namespace opengl {
         uint32_t m_RendererID{};
         GLenum m_InternalFormat, m_DataFormat;
     };
+
+    class Texture2DArray : public oak::Texture2DArray
+    {
+    public:
+        Texture2DArray(const oak::TextureSpecification& specification, uint32_t layerCount);
+        ~Texture2DArray() override;
+
+        const oak::TextureSpecification& getSpecification() const override
+        {
+            return m_Specification;
+        }
+
+        uint32_t getLayerCount() const override
+        {
+            return m_LayerCount;
+        }
+
+        uint32_t getRendererID() const override
+        {
+            return m_RendererID;
+        }
+
+        void copyToLayer(uint32_t layer, const oak::Texture2D& texture) override;
+        void copyLayers(const oak::Texture2DArray& source, uint32_t count) override;
+
+        void bind(uint32_t slot = 0) const override;
+
+    private:
+        oak::TextureSpecification m_Specification;
+
+        uint32_t m_LayerCount{};
+        uint32_t m_RendererID{};
+    };
 }
@@ -67,6 +67,18 @@ namespace opengl {
     {
         OAK_PROFILE_FUNCTION();
 
+        addBuffer(vertexBuffer, 0);
+    }
+
+    void VertexArray::addInstanceBuffer(const oak::Ref<oak::VertexBuffer>& instanceBuffer)
+    {
+        OAK_PROFILE_FUNCTION();
+
+        addBuffer(instanceBuffer, 1);
+    }
+
+    void VertexArray::addBuffer(const oak::Ref<oak::VertexBuffer>& vertexBuffer, uint32_t divisor)
+    {
         if (vertexBuffer->getLayout().getElements().size() == 0) {
             throw std::invalid_argument("Vertex Buffer has no layout!");
         }
@@ -88,6 +100,7 @@ namespace opengl {
                         element.normalized ? GL_TRUE : GL_FALSE,
                         layout.getStride(),
                         reinterpret_cast<const void*>(element.offset));
+                    glVertexAttribDivisor(m_VertexBufferIndex, divisor);
                     m_VertexBufferIndex++;
                     break;
                 }
@@ -103,6 +116,7 @@ namespace opengl {
                         shaderDataTypeToOpenGLBaseType(element.type),
                         layout.getStride(),
                         reinterpret_cast<const void*>(element.offset));
+                    glVertexAttribDivisor(m_VertexBufferIndex, divisor);
                     m_VertexBufferIndex++;
                     break;
                 }
@@ -119,7 +133,7 @@ namespace opengl {
                             element.normalized ? GL_TRUE : GL_FALSE,
                             layout.getStride(),
                             reinterpret_cast<const void*>((element.offset + sizeof(float) * count * i)));
-                        glVertexAttribDivisor(m_VertexBufferIndex, 1);
+                        glVertexAttribDivisor(m_VertexBufferIndex, std::max(divisor, 1u));
                         m_VertexBufferIndex++;
                     }
                     break;
@@ -13,12 +13,15 @@ namespace opengl {
         void unbind() const override;
 
         void addVertexBuffer(const oak::Ref<oak::VertexBuffer>& vertexBuffer) override;
+        void addInstanceBuffer(const oak::Ref<oak::VertexBuffer>& instanceBuffer) override;
         void setIndexBuffer(const oak::Ref<oak::IndexBuffer>& indexBuffer) override;
 
         const std::vector<oak::Ref<oak::VertexBuffer>>& getVertexBuffers() const { return m_VertexBuffers; }
         const oak::Ref<oak::IndexBuffer>& getIndexBuffer() const { return m_IndexBuffer; }
 
     private:
+        void addBuffer(const oak::Ref<oak::VertexBuffer>& buffer, uint32_t divisor);
+
         uint32_t m_RendererID{};
         uint32_t m_VertexBufferIndex{ 0 };
         std::vector<oak::Ref<oak::VertexBuffer>> m_VertexBuffers;
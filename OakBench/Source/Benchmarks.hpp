@@ -0,0 +1,6 @@
+#pragma once
+
+// Standalone CPU-only harnesses, each prints its own results
+void runSpatialIndexBench();
+// False when a packed rectangle left the packer, overlapped another or occupancy did not add up
+bool runSkylinePackerCheck();
@@ -0,0 +1,10 @@
+#include "Benchmarks.hpp"
+
+int main()
+{
+    const auto passed = runSkylinePackerCheck();
+
+    runSpatialIndexBench();
+
+    return passed ? 0 : 1;
+}
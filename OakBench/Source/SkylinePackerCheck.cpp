@@ -0,0 +1,125 @@
+#include "Benchmarks.hpp"
+
+#include "Oak/Renderer/SkylinePacker.hpp"
+
+#include <cmath>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+static constexpr uint32_t packerSize = 512;
+
+struct PackedRect
+{
+    glm::uvec2 position;
+    uint32_t width;
+    uint32_t height;
+};
+
+// Marks every texel of the live rectangles, fails on one outside the packer or covered twice
+static bool checkPlacement(const std::vector<PackedRect>& rects)
+{
+    std::vector<uint8_t> texels(packerSize * packerSize, 0);
+    for (const auto& rect : rects) {
+        if (rect.position.x + rect.width > packerSize || rect.position.y + rect.height > packerSize) {
+            std::printf("  %ux%u at (%u, %u) is outside the packer\n", rect.width, rect.height, rect.position.x, rect.position.y);
+            return false;
+        }
+
+        for (uint32_t y = rect.position.y; y < rect.position.y + rect.height; y++) {
+            for (uint32_t x = rect.position.x; x < rect.position.x + rect.width; x++) {
+                if (texels[y * packerSize + x]++) {
+                    std::printf("  %ux%u at (%u, %u) overlaps another rectangle\n", rect.width, rect.height, rect.position.x, rect.position.y);
+                    return false;
+                }
+            }
+        }
+    }
+
+    return true;
+}
+
+static bool checkOccupancy(const oak::SkylinePacker& packer, const std::vector<PackedRect>& rects)
+{
+    uint64_t area = 0;
+    for (const auto& rect : rects) {
+        area += (uint64_t)rect.width * rect.height;
+    }
+
+    const auto expected = (float)area / (float)(packerSize * packerSize);
+    if (std::abs(packer.getOccupancy() - expected) > 1.0e-6f) {
+        std::printf("  occupancy is %f, the live rectangles cover %f\n", packer.getOccupancy(), expected);
+        return false;
+    }
+
+    return true;
+}
+
+// Packs random rectangles until one does not fit
+static void fill(oak::SkylinePacker& packer, std::vector<PackedRect>& rects, std::mt19937& random)
+{
+    std::uniform_int_distribution<uint32_t> size(4, 68);
+    for (;;) {
+        const auto width = size(random);
+        const auto height = size(random);
+        const auto position = packer.pack(width, height);
+        if (!position) {
+            return;
+        }
+
+        rects.push_back({ *position, width, height });
+    }
+}
+
+static bool check(const char* name, bool passed)
+{
+    std::printf("%s %s\n", passed ? "ok  " : "FAIL", name);
+    return passed;
+}
+
+bool runSkylinePackerCheck()
+{
+    std::printf("SkylinePacker, %ux%u\n", packerSize, packerSize);
+
+    std::mt19937 random(packerSize);
+    oak::SkylinePacker packer(packerSize, packerSize);
+    std::vector<PackedRect> rects;
+
+    auto passed = true;
+
+    fill(packer, rects, random);
+    passed &= check("fill: placement", checkPlacement(rects));
+    passed &= check("fill: occupancy", checkOccupancy(packer, rects));
+    std::printf("     %zu rectangles, %.1f%% occupied\n", rects.size(), packer.getOccupancy() * 100.0f);
+
+    // Give back every other rectangle, the holes are reused before the skyline grows
+    std::vector<PackedRect> kept;
+    for (size_t i = 0; i < rects.size(); i++) {
+        if (i % 2) {
+            packer.release(rects[i].position, rects[i].width, rects[i].height);
+        }
+        else {
+            kept.push_back(rects[i]);
+        }
+    }
+    rects = std::move(kept);
+    passed &= check("release: occupancy", checkOccupancy(packer, rects));
+
+    const auto keptCount = rects.size();
+    fill(packer, rects, random);
+    passed &= check("refill: placement", checkPlacement(rects));
+    passed &= check("refill: occupancy", checkOccupancy(packer, rects));
+    passed &= check("refill: reuses released space", rects.size() > keptCount);
+    std::printf("     %zu rectangles, %.1f%% occupied\n", rects.size(), packer.getOccupancy() * 100.0f);
+
+    // Releasing everything leaves a packer that takes a rectangle of its full size again
+    for (const auto& rect : rects) {
+        packer.release(rect.position, rect.width, rect.height);
+    }
+    passed &= check("release all: empty", packer.getOccupancy() == 0.0f);
+
+    const auto full = packer.pack(packerSize, packerSize);
+    passed &= check("release all: full size fits", full && *full == glm::uvec2(0, 0));
+
+    return passed;
+}
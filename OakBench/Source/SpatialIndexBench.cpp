@@ -0,0 +1,80 @@
+#include "Benchmarks.hpp"
+
+#include "Oak/Core/Timer.hpp"
+#include "Oak/Scene/SpatialIndex.hpp"
+
+#include <cmath>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+static constexpr uint32_t queryCount = 1000;
+static constexpr float viewSize = 20.0f;
+
+struct Body
+{
+    glm::vec2 position;
+    glm::vec2 halfSize;
+};
+
+static void benchEntityCount(uint32_t entityCount)
+{
+    std::mt19937 random(entityCount);
+
+    // Keeps the density constant, so a query sees about the same number of entities at every count
+    const auto worldSize = 2.0f * std::sqrt(static_cast<float>(entityCount));
+    std::uniform_real_distribution<float> position(0.0f, worldSize);
+    std::uniform_real_distribution<float> size(0.25f, 1.0f);
+    std::uniform_real_distribution<float> step(-0.05f, 0.05f);
+
+    std::vector<Body> bodies(entityCount);
+    for (auto& body : bodies) {
+        body = { { position(random), position(random) }, { size(random), size(random) } };
+    }
+
+    oak::SpatialIndex index;
+
+    oak::Timer timer;
+    for (uint32_t i = 0; i < entityCount; i++) {
+        index.update(static_cast<entt::entity>(i), bodies[i].position - bodies[i].halfSize, bodies[i].position + bodies[i].halfSize);
+    }
+    const auto insertMs = timer.elapsedMillis();
+
+    // A frame of small movements, most bounds stay inside their fattened AABB
+    timer.reset();
+    for (uint32_t i = 0; i < entityCount; i++) {
+        bodies[i].position += glm::vec2(step(random), step(random));
+        index.update(static_cast<entt::entity>(i), bodies[i].position - bodies[i].halfSize, bodies[i].position + bodies[i].halfSize);
+    }
+    const auto updateMs = timer.elapsedMillis();
+
+    std::vector<glm::vec2> queries(queryCount);
+    for (auto& query : queries) {
+        query = { position(random), position(random) };
+    }
+
+    uint64_t hitCount = 0;
+    timer.reset();
+    for (const auto& query : queries) {
+        index.queryRegion(query, query + viewSize, [&](entt::entity) {
+            hitCount++;
+            return true;
+        });
+    }
+    const auto queryMs = timer.elapsedMillis();
+
+    std::printf("%8u entities | insert %9.2f ms (%6.1f ns each) | update %9.2f ms (%6.1f ns each) | query %7.3f ms (%6.2f us each, %llu hits)\n",
+        entityCount,
+        insertMs, insertMs * 1.0e6f / entityCount,
+        updateMs, updateMs * 1.0e6f / entityCount,
+        queryMs, queryMs * 1.0e3f / queryCount, static_cast<unsigned long long>(hitCount / queryCount));
+}
+
+void runSpatialIndexBench()
+{
+    std::printf("SpatialIndex, %u queries of %.0fx%.0f per count\n", queryCount, viewSize, viewSize);
+
+    for (auto entityCount : { 10'000u, 100'000u, 1'000'000u }) {
+        benchEntityCount(entityCount);
+    }
+}
@@ -0,0 +1,46 @@
+project "OakBench"
+    kind "ConsoleApp"
+    language "C++"
+    cppdialect "C++20"
+    staticruntime "off"
+
+    targetdir ("%{wks.location}/bin/" .. outputdir .. "/%{prj.name}")
+    objdir ("%{wks.location}/bin/int/" .. outputdir .. "/%{prj.name}")
+
+    files
+    {
+        "Source/**.hpp",
+        "Source/**.cpp"
+    }
+
+    includedirs
+    {
+        "%{IncludeDir.Box2D}",
+        "%{IncludeDir.entt}",
+        "%{IncludeDir.glm}",
+        "%{IncludeDir.spdlog}",
+        "%{wks.location}/Oak/Source",
+    }
+
+    links
+    {
+        "Oak"
+    }
+
+    filter "system:windows"
+        systemversion "latest"
+
+    filter "configurations:Debug"
+        defines "OAK_DEBUG"
+        runtime "Debug"
+        symbols "on"
+
+    filter "configurations:Release"
+        defines "OAK_RELEASE"
+        runtime "Release"
+        optimize "on"
+
+    filter "configurations:Dist"
+        defines "OAK_DIST"
+        runtime "Release"
+        optimize "on"
@@ -75,6 +75,7 @@ void EditorLayer::onUpdate(oak::Timestep t_timestep)
 
     // Render
     oak::Renderer2D::resetStats();
+    oak::ScriptEngine::resetStats();
     m_Framebuffer->bind();
     oak::RenderCommand::setClearColor({ 0.1f, 0.1f, 0.1f, 1 });
     oak::RenderCommand::clear();
@@ -113,8 +114,23 @@ void EditorLayer::onUpdate(oak::Timestep t_timestep)
     auto mouseY = static_cast<int>(my);
 
     if (mouseX >= 0 && mouseY >= 0 && mouseX < static_cast<int>(viewportSize.x) && mouseY < static_cast<int>(viewportSize.y)) {
-        auto pixelData = m_Framebuffer->readPixel(1, { mouseX, mouseY });
-        m_HoveredEntity = pixelData == -1 ? oak::Entity() : oak::Entity(static_cast<entt::entity>(pixelData), m_ActiveScene.get());
+        // Picked through the scene's spatial index instead of reading the entity ID attachment back from the GPU
+        auto viewProjection = m_EditorCamera.getViewProjection();
+        if (m_SceneState == SceneState::Play) {
+            auto camera = m_ActiveScene->getPrimaryCameraEntity();
+            if (camera) {
+                viewProjection = camera.getComponent<oak::CameraComponent>().camera.getProjection() * glm::inverse(camera.getComponent<oak::TransformComponent>().getWorldTransform());
+            }
+        }
+
+        auto ndc = glm::vec2(mx / viewportSize.x, my / viewportSize.y) * 2.0f - 1.0f;
+        auto inverseViewProjection = glm::inverse(viewProjection);
+        auto nearPoint = inverseViewProjection * glm::vec4(ndc, -1.0f, 1.0f);
+        auto farPoint = inverseViewProjection * glm::vec4(ndc, 1.0f, 1.0f);
+        auto rayOrigin = glm::vec3(nearPoint) / nearPoint.w;
+        auto rayDirection = glm::normalize(glm::vec3(farPoint) / farPoint.w - rayOrigin);
+
+        m_HoveredEntity = m_ActiveScene->pickEntity(rayOrigin, rayDirection);
     }
 
     onOverlayRender();
@@ -183,6 +199,7 @@ void EditorLayer::onImGuiRender()
 
     uiSettings();
     uiStatistics();
+    uiScriptStatistics();
     uiToolbar();
     uiViewport();
 
@@ -250,6 +267,51 @@ void EditorLayer::uiStatistics()
     ImGui::Text("Quads: %d", stats.quadCount);
     ImGui::Text("Vertices: %d", stats.getTotalVertexCount());
     ImGui::Text("Indices: %d", stats.getTotalIndexCount());
+    ImGui::Text("Visible: %d", stats.visibleCount);
+    ImGui::Text("Culled: %d", stats.culledCount);
+    ImGui::Text("Culled glyphs: %d", stats.culledGlyphCount);
+    ImGui::Text("Atlas Pages: %d (%.1f%% used)", stats.atlasPageCount, stats.atlasOccupancy * 100.0f);
+
+    ImGui::End();
+}
+
+void EditorLayer::uiScriptStatistics()
+{
+    ImGui::Begin("Script Statistics");
+
+    auto stats = oak::ScriptEngine::getStats();
+    ImGui::Text("GC Collections: %d", stats.gcCollections);
+
+    ImGui::Separator();
+    ImGui::Columns(4);
+    ImGui::Text("Class");
+    ImGui::NextColumn();
+    ImGui::Text("Instances");
+    ImGui::NextColumn();
+    ImGui::Text("OnCreate (ms)");
+    ImGui::NextColumn();
+    ImGui::Text("OnUpdate (ms)");
+    ImGui::NextColumn();
+    ImGui::Separator();
+    for (const auto& classStats : stats.classes) {
+        ImGui::Text("%s", classStats.className.c_str());
+        ImGui::NextColumn();
+        ImGui::Text("%d", classStats.instanceCount);
+        ImGui::NextColumn();
+        ImGui::Text("%.3f (%d)", classStats.onCreateTime, classStats.onCreateCalls);
+        ImGui::NextColumn();
+        ImGui::Text("%.3f (%d)", classStats.onUpdateTime, classStats.onUpdateCalls);
+        ImGui::NextColumn();
+    }
+    ImGui::Columns(1);
+
+    ImGui::Separator();
+    ImGui::Text("Internal Calls:");
+    for (const auto& call : stats.internalCalls) {
+        if (call.callCount > 0) {
+            ImGui::Text("%.*s: %d", (int)call.name.size(), call.name.data(), call.callCount);
+        }
+    }
 
     ImGui::End();
 }
@@ -379,7 +441,9 @@ void EditorLayer::uiViewport()
 
         // Entity transform
         auto& tc = selectedEntity.getComponent<oak::TransformComponent>();
-        auto transform = tc.getTransform();
+        auto transform = tc.getWorldTransform();
+        // world = parentWorld * local, so this recovers the parent's world matrix without a lookup
+        auto parentTransform = transform * glm::inverse(tc.getTransform());
 
         // Snapping
         auto snap = oak::Input::isKeyPressed(oak::Key::LeftControl);
@@ -395,12 +459,12 @@ void EditorLayer::uiViewport()
 
         if (ImGuizmo::IsUsing()) {
             glm::vec3 translation, rotation, scale;
-            oak::math::decomposeTransform(transform, translation, rotation, scale);
+            oak::math::decomposeTransform(glm::inverse(parentTransform) * transform, translation, rotation, scale);
 
-            auto deltaRotation = rotation - tc.rotation;
-            tc.translation = translation;
-            tc.rotation += deltaRotation;
-            tc.scale = scale;
+            auto deltaRotation = rotation - tc.getRotation();
+            tc.setTranslation(translation);
+            tc.setRotation(tc.getRotation() + deltaRotation);
+            tc.setScale(scale);
         }
     }
 
@@ -531,7 +595,7 @@ void EditorLayer::onOverlayRender()
             return;
         }
 
-        oak::Renderer2D::beginScene(camera.getComponent<oak::CameraComponent>().camera, camera.getComponent<oak::TransformComponent>().getTransform());
+        oak::Renderer2D::beginScene(camera.getComponent<oak::CameraComponent>().camera, camera.getComponent<oak::TransformComponent>().getWorldTransform());
     }
     else {
         oak::Renderer2D::beginScene(m_EditorCamera);
@@ -544,11 +608,11 @@ void EditorLayer::onOverlayRender()
             for (auto entity : view) {
                 auto [tc, bc2d] = view.get<oak::TransformComponent, oak::BoxCollider2DComponent>(entity);
 
-                auto translation = tc.translation + glm::vec3(bc2d.offset, 0.001f);
-                auto scale = tc.scale * glm::vec3(bc2d.size * 2.0f, 1.0f);
+                auto translation = tc.getTranslation() + glm::vec3(bc2d.offset, 0.001f);
+                auto scale = tc.getScale() * glm::vec3(bc2d.size * 2.0f, 1.0f);
 
-                auto transform = glm::translate(glm::mat4(1.0f), tc.translation)
-                    * glm::rotate(glm::mat4(1.0f), tc.rotation.z, glm::vec3(0.0f, 0.0f, 1.0f))
+                auto transform = glm::translate(glm::mat4(1.0f), tc.getTranslation())
+                    * glm::rotate(glm::mat4(1.0f), tc.getRotation().z, glm::vec3(0.0f, 0.0f, 1.0f))
                     * glm::translate(glm::mat4(1.0f), glm::vec3(bc2d.offset, 0.001f))
                     * glm::scale(glm::mat4(1.0f), scale);
 
@@ -562,8 +626,8 @@ void EditorLayer::onOverlayRender()
             for (auto entity : view) {
                 auto [tc, cc2d] = view.get<oak::TransformComponent, oak::CircleCollider2DComponent>(entity);
 
-                auto translation = tc.translation + glm::vec3(cc2d.offset, 0.001f);
-                auto scale = tc.scale * glm::vec3(cc2d.radius * 2.0f);
+                auto translation = tc.getTranslation() + glm::vec3(cc2d.offset, 0.001f);
+                auto scale = tc.getScale() * glm::vec3(cc2d.radius * 2.0f);
 
                 auto transform = glm::translate(glm::mat4(1.0f), translation) * glm::scale(glm::mat4(1.0f), scale);
 
@@ -575,7 +639,7 @@ void EditorLayer::onOverlayRender()
     // Draw selected entity outline
     if (auto selectedEntity = m_SceneHierarchyPanel.getSelectedEntity()) {
         const auto& transform = selectedEntity.getComponent<oak::TransformComponent>();
-        oak::Renderer2D::drawRect(transform.getTransform(), glm::vec4(1.0f, 0.5f, 0.0f, 1.0f));
+        oak::Renderer2D::drawRect(transform.getWorldTransform(), glm::vec4(1.0f, 0.5f, 0.0f, 1.0f));
     }
 
     oak::Renderer2D::endScene();
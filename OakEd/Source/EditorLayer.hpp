@@ -48,6 +48,7 @@ private:
     void uiMenuBar();
     void uiSettings();
     void uiStatistics();
+    void uiScriptStatistics();
     void uiToolbar();
     void uiViewport();
 
@@ -35,15 +35,32 @@ void SceneHierarchyPanel::onImGuiRender()
     ImGui::Begin("Scene Hierarchy");
 
     if (m_Context) {
+        // Children are drawn by their parents. Roots are collected first because the tree can be edited while drawing
+        std::vector<oak::Entity> roots;
         m_Context->m_Registry.each([&](auto entityID) {
             oak::Entity entity{ entityID , m_Context.get() };
-            drawEntityNode(entity);
+            if (!entity.hasComponent<oak::RelationshipComponent>() || entity.getComponent<oak::RelationshipComponent>().parent == 0) {
+                roots.push_back(entity);
+            }
         });
 
+        for (auto entity : roots) {
+            drawEntityNode(entity);
+        }
+
         if (ImGui::IsMouseDown(0) && ImGui::IsWindowHovered()) {
             m_SelectionContext = {};
         }
 
+        // Dropping an entity on blank space makes it a root again
+        if (ImGui::BeginDragDropTargetCustom(ImGui::GetCurrentWindow()->WorkRect, ImGui::GetID("Scene Hierarchy"))) {
+            if (const auto* payload = ImGui::AcceptDragDropPayload("SCENE_HIERARCHY_ENTITY")) {
+                auto dropped = m_Context->getEntityByUUID(*static_cast<const oak::UUID*>(payload->Data));
+                m_Context->unparentEntity(dropped);
+            }
+            ImGui::EndDragDropTarget();
+        }
+
         // Right-click on blank space
         if (ImGui::BeginPopupContextWindow(0, 1)) {
             if (ImGui::MenuItem("Create Empty Entity")) {
@@ -74,16 +91,54 @@ void SceneHierarchyPanel::drawEntityNode(oak::Entity entity)
 {
     auto& tag = entity.getComponent<oak::TagComponent>().tag;
 
+    // Copy, drag and drop below may edit the list
+    std::vector<oak::UUID> children;
+    auto hasParent{ false };
+    if (entity.hasComponent<oak::RelationshipComponent>()) {
+        const auto& relationship = entity.getComponent<oak::RelationshipComponent>();
+        children = relationship.children;
+        hasParent = relationship.parent != 0;
+    }
+
     ImGuiTreeNodeFlags flags = ((m_SelectionContext == entity) ? ImGuiTreeNodeFlags_Selected : 0) | ImGuiTreeNodeFlags_OpenOnArrow;
     flags |= ImGuiTreeNodeFlags_SpanAvailWidth;
+    if (children.empty()) {
+        flags |= ImGuiTreeNodeFlags_Leaf;
+    }
 
     auto opened = ImGui::TreeNodeEx(reinterpret_cast<void*>(static_cast<uint64_t>(static_cast<uint32_t>(entity))), flags, tag.c_str());
     if (ImGui::IsItemClicked()) {
         m_SelectionContext = entity;
     }
 
+    if (ImGui::BeginDragDropSource()) {
+        auto uuid = entity.getUUID();
+        ImGui::SetDragDropPayload("SCENE_HIERARCHY_ENTITY", &uuid, sizeof(oak::UUID));
+        ImGui::Text("%s", tag.c_str());
+        ImGui::EndDragDropSource();
+    }
+
+    if (ImGui::BeginDragDropTarget()) {
+        if (const auto* payload = ImGui::AcceptDragDropPayload("SCENE_HIERARCHY_ENTITY")) {
+            auto dropped = m_Context->getEntityByUUID(*static_cast<const oak::UUID*>(payload->Data));
+            if (dropped && dropped != entity) {
+                m_Context->parentEntity(dropped, entity);
+            }
+        }
+        ImGui::EndDragDropTarget();
+    }
+
     auto entityDeleted{ false };
     if (ImGui::BeginPopupContextItem()) {
+        if (ImGui::MenuItem("Create Child Entity")) {
+            auto child = m_Context->createEntity("Empty Entity");
+            m_Context->parentEntity(child, entity);
+        }
+
+        if (hasParent && ImGui::MenuItem("Unparent Entity")) {
+            m_Context->unparentEntity(entity);
+        }
+
         if (ImGui::MenuItem("Delete Entity")) {
             entityDeleted = true;
         }
@@ -92,11 +147,11 @@ void SceneHierarchyPanel::drawEntityNode(oak::Entity entity)
     }
 
     if (opened) {
-        ImGuiTreeNodeFlags flags = ImGuiTreeNodeFlags_OpenOnArrow | ImGuiTreeNodeFlags_SpanAvailWidth;
-
-        auto opened = ImGui::TreeNodeEx(reinterpret_cast<void*>(9817239), flags, tag.c_str());
-        if (opened) {
-            ImGui::TreePop();
+        for (auto child : children) {
+            auto childEntity = m_Context->getEntityByUUID(child);
+            if (childEntity) {
+                drawEntityNode(childEntity);
+            }
         }
 
         ImGui::TreePop();
@@ -104,7 +159,8 @@ void SceneHierarchyPanel::drawEntityNode(oak::Entity entity)
 
     if (entityDeleted) {
         m_Context->destroyEntity(entity);
-        if (m_SelectionContext == entity) {
+        // Children are destroyed too, so the selection may be gone even if it was not this entity
+        if (m_SelectionContext && !m_Context->m_Registry.valid(m_SelectionContext)) {
             m_SelectionContext = {};
         }
     }
@@ -253,11 +309,24 @@ void SceneHierarchyPanel::drawComponents(oak::Entity entity)
     ImGui::PopItemWidth();
 
     drawComponent<oak::TransformComponent>("Transform", entity, [](auto& component) {
-        drawVec3Control("Translation", component.translation);
-        auto rotation = glm::degrees(component.rotation);
+        // Only write back edited values, every setter invalidates the cached matrix
+        auto translation = component.getTranslation();
+        drawVec3Control("Translation", translation);
+        if (translation != component.getTranslation()) {
+            component.setTranslation(translation);
+        }
+
+        auto rotation = glm::degrees(component.getRotation());
         drawVec3Control("Rotation", rotation);
-        component.rotation = glm::radians(rotation);
-        drawVec3Control("Scale", component.scale, 1.0f);
+        if (rotation != glm::degrees(component.getRotation())) {
+            component.setRotation(glm::radians(rotation));
+        }
+
+        auto scale = component.getScale();
+        drawVec3Control("Scale", scale, 1.0f);
+        if (scale != component.getScale()) {
+            component.setScale(scale);
+        }
     });
 
     drawComponent<oak::CameraComponent>("Camera", entity, [](auto& component) {
@@ -336,14 +405,14 @@ void SceneHierarchyPanel::drawComponents(oak::Entity entity)
         // Fields
         auto sceneRunning = scene->isRunning();
         if (sceneRunning) {
-            auto scriptInstance = oak::ScriptEngine::getEntityScriptInstance(entity.getUUID());
+            auto scriptInstance = oak::ScriptEngine::getEntityScriptInstance(entity);
             if (scriptInstance) {
                 const auto& fields = scriptInstance->getScriptClass()->getFields();
-                for (const auto& [name, field] : fields) {
+                for (const auto& field : fields) {
                     if (field.type == oak::ScriptFieldType::Float) {
-                        auto data = scriptInstance->getFieldValue<float>(name);
-                        if (ImGui::DragFloat(name.c_str(), &data)) {
-                            scriptInstance->setFieldValue(name, data);
+                        auto data = scriptInstance->getFieldValue<float>(field);
+                        if (ImGui::DragFloat(field.name.c_str(), &data)) {
+                            scriptInstance->setFieldValue(field, data);
                         }
                     }
                 }
@@ -354,29 +423,16 @@ void SceneHierarchyPanel::drawComponents(oak::Entity entity)
                 auto entityClass = oak::ScriptEngine::getEntityClass(component.className);
                 const auto& fields = entityClass->getFields();
 
-                auto& entityFields = oak::ScriptEngine::getScriptFieldMap(entity);
-                for (const auto& [name, field] : fields) {
-                    // Field has been set in editor
-                    if (entityFields.find(name) != entityFields.end()) {
-                        auto& scriptField = entityFields.at(name);
-
-                        // Display control to set it maybe
-                        if (field.type == oak::ScriptFieldType::Float) {
-                            auto data = scriptField.getValue<float>();
-                            if (ImGui::DragFloat(name.c_str(), &data)) {
-                                scriptField.setValue(data);
-                            }
-                        }
-                    }
-                    else {
-                        // Display control to set it maybe
-                        if (field.type == oak::ScriptFieldType::Float) {
-                            auto data = 0.0f;
-                            if (ImGui::DragFloat(name.c_str(), &data)) {
-                                auto& fieldInstance = entityFields[name];
-                                fieldInstance.field = field;
-                                fieldInstance.setValue(data);
-                            }
+                // Unset fields read as zero and become set once edited
+                auto* entityFields = oak::ScriptEngine::getScriptFields(entity);
+                for (const auto& field : fields) {
+                    auto& scriptField = entityFields[field.index];
+
+                    // Display control to set it maybe
+                    if (field.type == oak::ScriptFieldType::Float) {
+                        auto data = scriptField.getValue<float>();
+                        if (ImGui::DragFloat(field.name.c_str(), &data)) {
+                            scriptField.setValue(data);
                         }
                     }
                 }
@@ -453,11 +509,16 @@ void SceneHierarchyPanel::drawComponents(oak::Entity entity)
         ImGui::DragFloat("Restitution Threshold", &component.restitutionThreshold, 0.01f, 0.0f);
     });
 
-    drawComponent<oak::TextComponent>("Text Renderer", entity, [](auto& component) {
-        ImGui::InputTextMultiline("Text String", &component.textString);
+    drawComponent<oak::TextComponent>("Text Renderer", entity, [entity](auto& component) mutable {
+        auto resized = ImGui::InputTextMultiline("Text String", &component.textString);
         ImGui::ColorEdit4("Color", glm::value_ptr(component.color));
-        ImGui::DragFloat("Kerning", &component.kerning, 0.025f);
-        ImGui::DragFloat("Line Spacing", &component.lineSpacing, 0.025f);
+        resized |= ImGui::DragFloat("Kerning", &component.kerning, 0.025f);
+        resized |= ImGui::DragFloat("Line Spacing", &component.lineSpacing, 0.025f);
+
+        // The scene measures the text again for its spatial index
+        if (resized) {
+            entity.patchComponent<oak::TextComponent>();
+        }
     });
 
 }
@@ -0,0 +1,122 @@
+// Instanced Texture Array Shader
+// Each instance is one quad; corners are expanded from gl_VertexIndex (0..3)
+
+#type vertex
+#version 450 core
+
+layout(location = 0) in vec3 a_AxisX;
+layout(location = 1) in vec3 a_AxisY;
+layout(location = 2) in vec3 a_Origin;
+layout(location = 3) in vec4 a_Color;
+layout(location = 4) in float a_TexIndex;
+layout(location = 5) in float a_TilingFactor;
+layout(location = 6) in int a_EntityID;
+layout(location = 7) in float a_TexLayer;
+layout(location = 8) in vec4 a_TexRect; // UV min (xy) and max (zw)
+
+layout(std140, binding = 0) uniform Camera
+{
+	mat4 u_ViewProjection;
+};
+
+struct VertexOutput
+{
+	vec4 Color;
+	vec2 TexCoord;
+	float TilingFactor;
+};
+
+layout (location = 0) out VertexOutput Output;
+layout (location = 3) out flat float v_TexIndex;
+layout (location = 4) out flat int v_EntityID;
+layout (location = 5) out flat float v_TexLayer;
+
+const vec2 s_TexCoords[4] = vec2[4](
+	vec2(0.0, 0.0),
+	vec2(1.0, 0.0),
+	vec2(1.0, 1.0),
+	vec2(0.0, 1.0)
+);
+
+void main()
+{
+	vec2 texCoord = s_TexCoords[gl_VertexIndex & 3];
+	vec2 corner = texCoord - vec2(0.5);
+	vec3 position = a_Origin + a_AxisX * corner.x + a_AxisY * corner.y;
+
+	Output.Color = a_Color;
+	Output.TexCoord = mix(a_TexRect.xy, a_TexRect.zw, texCoord);
+	Output.TilingFactor = a_TilingFactor;
+	v_TexIndex = a_TexIndex;
+	v_EntityID = a_EntityID;
+	v_TexLayer = a_TexLayer;
+
+	gl_Position = u_ViewProjection * vec4(position, 1.0);
+}
+
+#type fragment
+#version 450 core
+
+layout(location = 0) out vec4 o_Color;
+layout(location = 1) out int o_EntityID;
+
+struct VertexOutput
+{
+	vec4 Color;
+	vec2 TexCoord;
+	float TilingFactor;
+};
+
+layout (location = 0) in VertexOutput Input;
+layout (location = 3) in flat float v_TexIndex;
+layout (location = 4) in flat int v_EntityID;
+layout (location = 5) in flat float v_TexLayer;
+
+layout (binding = 0) uniform sampler2DArray u_Textures[32];
+
+void main()
+{
+	vec4 texColor = Input.Color;
+
+	switch(int(v_TexIndex))
+	{
+		case  0: texColor *= texture(u_Textures[ 0], vec3(Input.TexCoord * Input.TilingFactor, v_TexLayer)); break;
+		case  1: texColor *= texture(u_Textures[ 1], vec3(Input.TexCoord * Input.TilingFactor, v_TexLayer)); break;
+		case  2: texColor *= texture(u_Textures[ 2], vec3(Input.TexCoord * Input.TilingFactor, v_TexLayer)); break;
+		case  3: texColor *= texture(u_Textures[ 3], vec3(Input.TexCoord * Input.TilingFactor, v_TexLayer)); break;
+		case  4: texColor *= texture(u_Textures[ 4], vec3(Input.TexCoord * Input.TilingFactor, v_TexLayer)); break;
+		case  5: texColor *= texture(u_Textures[ 5], vec3(Input.TexCoord * Input.TilingFactor, v_TexLayer)); break;
+		case  6: texColor *= texture(u_Textures[ 6], vec3(Input.TexCoord * Input.TilingFactor, v_TexLayer)); break;
+		case  7: texColor *= texture(u_Textures[ 7], vec3(Input.TexCoord * Input.TilingFactor, v_TexLayer)); break;
+		case  8: texColor *= texture(u_Textures[ 8], vec3(Input.TexCoord * Input.TilingFactor, v_TexLayer)); break;
+		case  9: texColor *= texture(u_Textures[ 9], vec3(Input.TexCoord * Input.TilingFactor, v_TexLayer)); break;
+		case 10: texColor *= texture(u_Textures[10], vec3(Input.TexCoord * Input.TilingFactor, v_TexLayer)); break;
+		case 11: texColor *= texture(u_Textures[11], vec3(Input.TexCoord * Input.TilingFactor, v_TexLayer)); break;
+		case 12: texColor *= texture(u_Textures[12], vec3(Input.TexCoord * Input.TilingFactor, v_TexLayer)); break;
+		case 13: texColor *= texture(u_Textures[13], vec3(Input.TexCoord * Input.TilingFactor, v_TexLayer)); break;
+		case 14: texColor *= texture(u_Textures[14], vec3(Input.TexCoord * Input.TilingFactor, v_TexLayer)); break;
+		case 15: texColor *= texture(u_Textures[15], vec3(Input.TexCoord * Input.TilingFactor, v_TexLayer)); break;
+		case 16: texColor *= texture(u_Textures[16], vec3(Input.TexCoord * Input.TilingFactor, v_TexLayer)); break;
+		case 17: texColor *= texture(u_Textures[17], vec3(Input.TexCoord * Input.TilingFactor, v_TexLayer)); break;
+		case 18: texColor *= texture(u_Textures[18], vec3(Input.TexCoord * Input.TilingFactor, v_TexLayer)); break;
+		case 19: texColor *= texture(u_Textures[19], vec3(Input.TexCoord * Input.TilingFactor, v_TexLayer)); break;
+		case 20: texColor *= texture(u_Textures[20], vec3(Input.TexCoord * Input.TilingFactor, v_TexLayer)); break;
+		case 21: texColor *= texture(u_Textures[21], vec3(Input.TexCoord * Input.TilingFactor, v_TexLayer)); break;
+		case 22: texColor *= texture(u_Textures[22], vec3(Input.TexCoord * Input.TilingFactor, v_TexLayer)); break;
+		case 23: texColor *= texture(u_Textures[23], vec3(Input.TexCoord * Input.TilingFactor, v_TexLayer)); break;
+		case 24: texColor *= texture(u_Textures[24], vec3(Input.TexCoord * Input.TilingFactor, v_TexLayer)); break;
+		case 25: texColor *= texture(u_Textures[25], vec3(Input.TexCoord * Input.TilingFactor, v_TexLayer)); break;
+		case 26: texColor *= texture(u_Textures[26], vec3(Input.TexCoord * Input.TilingFactor, v_TexLayer)); break;
+		case 27: texColor *= texture(u_Textures[27], vec3(Input.TexCoord * Input.TilingFactor, v_TexLayer)); break;
+		case 28: texColor *= texture(u_Textures[28], vec3(Input.TexCoord * Input.TilingFactor, v_TexLayer)); break;
+		case 29: texColor *= texture(u_Textures[29], vec3(Input.TexCoord * Input.TilingFactor, v_TexLayer)); break;
+		case 30: texColor *= texture(u_Textures[30], vec3(Input.TexCoord * Input.TilingFactor, v_TexLayer)); break;
+		case 31: texColor *= texture(u_Textures[31], vec3(Input.TexCoord * Input.TilingFactor, v_TexLayer)); break;
+	}
+
+	if (texColor.a == 0.0)
+		discard;
+
+	o_Color = texColor;
+	o_EntityID = v_EntityID;
+}
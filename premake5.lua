@@ -46,4 +46,5 @@ workspace "Oak"
 
     group "Tools"
         include "OakEd"
+        include "OakBench"
     group ""